@@ -1,12 +1,15 @@
 #ifndef CHESS_HIERARCHY_H
 #define CHESS_HIERARCHY_H
 
+#include <atomic>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <cstring>
 
 /**
  * @namespace Chess
@@ -24,12 +27,70 @@ enum class Color {
     BLACK  /**< Чёрный цвет */
 };
 
+/**
+ * @brief Язык текстовых описаний фигур
+ */
+enum class Language {
+    RUSSIAN, /**< Русский (по умолчанию) */
+    ENGLISH  /**< Английский */
+};
+
+/**
+ * @brief Таблицы текстовых описаний фигур
+ *
+ * Строки статические: методы getType(), getMoveType() и getCombinedAbilities()
+ * возвращают std::string_view на них и ничего не выделяют.
+ */
+namespace text {
+
+/**
+ * @brief Названия классов иерархии
+ */
+enum PieceTitle { CHESS_PIECE, SLIDING_PIECE, JUMPING_PIECE, KNIGHT, ROOK, BISHOP, QUEEN, KING, TITLE_COUNT };
+
+inline constexpr std::string_view TITLES[2][TITLE_COUNT] = {
+    {"Шахматная фигура", "Скользящая фигура", "Прыгающая фигура", "Конь", "Ладья", "Слон", "Ферзь", "Король"},
+    {"Chess piece", "Sliding piece", "Jumping piece", "Knight", "Rook", "Bishop", "Queen", "King"}
+};
+
+/// Направления движения по маске: 1 — горизонталь, 2 — вертикаль, 4 — диагональ
+inline constexpr std::string_view MOVE_TYPES[2][8] = {
+    {"Неизвестно", "Только горизонталь", "Только вертикаль", "Горизонталь и вертикаль",
+     "Только диагональ", "Горизонталь и диагональ", "Вертикаль и диагональ",
+     "Все направления (горизонталь, вертикаль, диагональ)"},
+    {"Unknown", "Horizontal only", "Vertical only", "Horizontal and vertical",
+     "Diagonal only", "Horizontal and diagonal", "Vertical and diagonal",
+     "All directions (horizontal, vertical, diagonal)"}
+};
+
+inline constexpr std::string_view QUEEN_ABILITIES[2] = {
+    "Объединяет возможности ладьи (горизонталь/вертикаль) "
+    "и слона (диагональ). Может двигаться на любое количество клеток "
+    "в любом направлении. Является самой сильной фигурой на доске.",
+    "Combines the rook (horizontal/vertical) and the bishop (diagonal). "
+    "Moves any number of squares in any direction. "
+    "The strongest piece on the board."
+};
+
+/**
+ * @brief Название класса фигуры
+ * @param title Класс
+ * @param lang Язык
+ * @return Строка из статической таблицы
+ */
+constexpr std::string_view title(PieceTitle title, Language lang) {
+    return TITLES[static_cast<int>(lang)][title];
+}
+
+}
+
 /**
  * @brief Абстрактный базовый класс для всех шахматных фигур
  * 
  * Класс определяет общий интерфейс для всех шахматных фигур,
  * включая проверку возможности хода и получение символа фигуры.
- * Содержит статические счётчики для отслеживания количества фигур.
+ * Содержит статические счётчики для отслеживания количества фигур;
+ * счётчики атомарные, поэтому фигуры можно создавать из разных потоков.
  */
 class ChessPiece {
 protected:
@@ -38,8 +99,8 @@ protected:
     int y;                
     bool hasMoved;        
     
-    static int whiteCount;
-    static int blackCount;
+    inline static std::atomic<int> whiteCount{0};
+    inline static std::atomic<int> blackCount{0};
     
 public:
     /**
@@ -176,11 +237,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Виртуальная функция с реализацией по умолчанию.
      */
-    virtual std::string getType() const { return "Шахматная фигура"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const { return text::title(text::CHESS_PIECE, lang); }
     
     /**
      * @brief Статическая функция для проверки состояния доски
@@ -211,17 +273,36 @@ public:
     static int getTotalCount() { return whiteCount + blackCount; }
 };
 
-std::ostream& operator<<(std::ostream& os, const ChessPiece& piece) {
-    os << (piece.getColor() == Color::WHITE ? "W" : "B") << " ";
-    os << piece.getType();
+/// Наибольшая длина записи фигуры formatPiece() в байтах
+constexpr std::size_t PIECE_TEXT_MAX = 48;
+
+/**
+ * @brief Записать фигуру в буфер в виде "W Конь[1,0]"
+ * @param out Буфер не короче PIECE_TEXT_MAX байт
+ * @param piece Фигура
+ * @param lang Язык названия
+ * @return Указатель за последним записанным символом (завершающий ноль не пишется)
+ */
+inline char* formatPiece(char* out, const ChessPiece& piece, Language lang = Language::RUSSIAN) {
+    *out++ = piece.getColor() == Color::WHITE ? 'W' : 'B';
+    *out++ = ' ';
+    std::string_view type = piece.getType(lang);
+    std::memcpy(out, type.data(), type.size());
+    out += type.size();
     int x, y;
     piece.getPosition(x, y);
-    os << "[" << x << "," << y << "]";
-    return os;
+    *out++ = '[';
+    *out++ = static_cast<char>('0' + x);
+    *out++ = ',';
+    *out++ = static_cast<char>('0' + y);
+    *out++ = ']';
+    return out;
 }
 
-int ChessPiece::whiteCount = 0;
-int ChessPiece::blackCount = 0;
+inline std::ostream& operator<<(std::ostream& os, const ChessPiece& piece) {
+    char buffer[PIECE_TEXT_MAX];
+    return os.write(buffer, formatPiece(buffer, piece) - buffer);
+}
 
 /**
  * @brief Базовый класс для фигур, двигающихся по прямым линиям
@@ -299,38 +380,25 @@ public:
     
     /**
      * @brief Получить тип движения фигуры
-     * @return Строковое описание возможных направлений движения
+     * @param lang Язык описания
+     * @return Описание возможных направлений движения (статическая строка)
      * 
      * Виртуальная функция с реализацией по умолчанию.
      * Может быть переопределена в производных классах.
      */
-    virtual std::string getMoveType() const {
-    if (canMoveHorizontally && canMoveVertically && canMoveDiagonally) {
-        return "Все направления (горизонталь, вертикаль, диагональ)";
-    } else if (canMoveHorizontally && canMoveVertically) {
-        return "Горизонталь и вертикаль";
-    } else if (canMoveHorizontally && canMoveDiagonally) {
-        return "Горизонталь и диагональ";
-    } else if (canMoveVertically && canMoveDiagonally) {
-        return "Вертикаль и диагональ";
-    } else if (canMoveHorizontally) {
-        return "Только горизонталь";
-    } else if (canMoveVertically) {
-        return "Только вертикаль";
-    } else if (canMoveDiagonally) {
-        return "Только диагональ";
-    } else {
-        return "Неизвестно";
-    }
+    virtual std::string_view getMoveType(Language lang = Language::RUSSIAN) const {
+    return text::MOVE_TYPES[static_cast<int>(lang)][(canMoveHorizontally ? 1 : 0) | (canMoveVertically ? 2 : 0)
+                                                    | (canMoveDiagonally ? 4 : 0)];
 };
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Скользящая фигура"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::SLIDING_PIECE, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -355,10 +423,35 @@ protected:
         int deltaY;
     };
     
-    static const MovePattern movePatterns[8]; ///< Шаблоны допустимых ходов
-    static int patternCount;                 ///< Количество шаблонов
+    static constexpr MovePattern movePatterns[8] = {
+        {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
+        {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+    };                                       ///< Шаблоны допустимых ходов
+    inline static int patternCount = 8;      ///< Количество шаблонов
     
 public:
+    /**
+     * @brief Получить размер таблицы шаблонов движения
+     * @return Количество элементов в movePatterns
+     */
+    static constexpr int getPatternTableSize() {
+        return sizeof(movePatterns) / sizeof(movePatterns[0]);
+    }
+    
+    /**
+     * @brief Получить смещение шаблона по X
+     * @param i Номер шаблона
+     * @return Смещение по горизонтали
+     */
+    static constexpr int getPatternDeltaX(int i) { return movePatterns[i].deltaX; }
+    
+    /**
+     * @brief Получить смещение шаблона по Y
+     * @param i Номер шаблона
+     * @return Смещение по вертикали
+     */
+    static constexpr int getPatternDeltaY(int i) { return movePatterns[i].deltaY; }
+    
     /**
      * @brief Конструктор прыгающей фигуры
      * @param col Цвет фигуры
@@ -430,11 +523,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Прыгающая фигура"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::JUMPING_PIECE, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -442,12 +536,6 @@ public:
     virtual ~JumpingPiece() = default;
 };
 
-const JumpingPiece::MovePattern JumpingPiece::movePatterns[8] = {
-    {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
-    {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
-};
-int JumpingPiece::patternCount = 8;
-
 /**
  * @brief Класс шахматного коня
  * 
@@ -467,11 +555,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Конь"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::KNIGHT, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -499,11 +588,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Ладья"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::ROOK, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -531,11 +621,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Слон"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::BISHOP, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -561,11 +652,12 @@ public:
     
     /**
      * @brief Получить описание комбинированных возможностей
-     * @return Строковое описание возможностей фигуры
+     * @param lang Язык описания
+     * @return Описание возможностей фигуры (статическая строка)
      * 
      * Чисто виртуальная функция, должна быть реализована в производных классах.
      */
-    virtual std::string getCombinedAbilities() const = 0;
+    virtual std::string_view getCombinedAbilities(Language lang = Language::RUSSIAN) const = 0;
     
     /**
      * @brief Проверить специальные возможности фигуры
@@ -598,14 +690,13 @@ public:
     
     /**
      * @brief Получить описание комбинированных возможностей
-     * @return Строковое описание возможностей ферзя
+     * @param lang Язык описания
+     * @return Описание возможностей ферзя (статическая строка)
      * 
      * Реализует чисто виртуальную функцию интерфейса CombinedPiece.
      */
-    virtual std::string getCombinedAbilities() const override {
-    return "Объединяет возможности ладьи (горизонталь/вертикаль) "
-           "и слона (диагональ). Может двигаться на любое количество клеток "
-           "в любом направлении. Является самой сильной фигурой на доске.";
+    virtual std::string_view getCombinedAbilities(Language lang = Language::RUSSIAN) const override {
+    return text::QUEEN_ABILITIES[static_cast<int>(lang)];
     }
     
     /**
@@ -618,11 +709,12 @@ public:
     
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Ферзь"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::QUEEN, lang); }
     
     /**
      * @brief Виртуальный деструктор
@@ -641,8 +733,8 @@ public:
  */
 class King : public ChessPiece {
 private:
-    static int whiteKingCount;  ///< Счётчик белых королей
-    static int blackKingCount;  ///< Счётчик чёрных королей
+    inline static std::atomic<int> whiteKingCount{0};  ///< Счётчик белых королей
+    inline static std::atomic<int> blackKingCount{0};  ///< Счётчик чёрных королей
     
 public:
     /**
@@ -654,17 +746,12 @@ public:
      */
     King(Color col, int posX, int posY)
     : ChessPiece(col, posX, posY) {
-    // Проверка максимального количества королей
-    if ((color == Color::WHITE && whiteKingCount >= 1) ||
-        (color == Color::BLACK && blackKingCount >= 1)) {
+    // Проверка и занятие места короля одной атомарной операцией
+    std::atomic<int>& kings = color == Color::WHITE ? whiteKingCount : blackKingCount;
+    int expected = 0;
+    if (!kings.compare_exchange_strong(expected, 1)) {
         throw std::logic_error("Не может быть более одного короля каждого цвета");
     }
-    
-    if (color == Color::WHITE) {
-        ++whiteKingCount;
-    } else {
-        ++blackKingCount;
-    }
 };
     
     /**
@@ -703,20 +790,30 @@ public:
         return false;
     }
     
-    // Король может двигаться только на одну клетку в любом направлении
-    int deltaX = abs(newX - posX);
-    int deltaY = abs(newY - posY);
-    
-    return deltaX <= 1 && deltaY <= 1;
+    return isStep(newX - posX, newY - posY);
 };
     
+    /**
+     * @brief Проверить, является ли смещение шагом короля
+     * @param deltaX Смещение по X
+     * @param deltaY Смещение по Y
+     * @return true если смещение не больше одной клетки в любом направлении
+     * 
+     * Король может двигаться только на одну клетку в любом направлении.
+     */
+    static constexpr bool isStep(int deltaX, int deltaY) {
+        return (deltaX != 0 || deltaY != 0) &&
+               deltaX >= -1 && deltaX <= 1 && deltaY >= -1 && deltaY <= 1;
+    }
+    
     /**
      * @brief Получить тип фигуры
-     * @return Строковое представление типа фигуры
+     * @param lang Язык названия
+     * @return Название типа фигуры (статическая строка)
      * 
      * Переопределяет виртуальную функцию базового класса.
      */
-    virtual std::string getType() const override { return "Король"; }
+    virtual std::string_view getType(Language lang = Language::RUSSIAN) const override { return text::title(text::KING, lang); }
     
     /**
      * @brief Получить количество королей каждого цвета
@@ -750,8 +847,6 @@ public:
     return whiteCount <= 16 && blackCount <= 16 && King::validateKings();
 }
 };
-int King::whiteKingCount = 0;
-int King::blackKingCount = 0;
 }
 
 
@@ -0,0 +1,154 @@
+#ifndef CHESS_ANALYSIS_H
+#define CHESS_ANALYSIS_H
+
+#include "search.h"
+#include "thread_pool.h"
+#include "tt.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Оценка качества хода
+ */
+enum class MoveAnnotation {
+    NONE,    /**< Ход в пределах допустимой потери */
+    MISTAKE, /**< Ошибка ("?") */
+    BLUNDER  /**< Грубая ошибка ("??") */
+};
+
+/**
+ * @brief Настройки анализа партии
+ */
+struct AnalysisOptions {
+    SearchLimits limits;          ///< Ограничения перебора каждой позиции (обычно глубина)
+    int mistakeThreshold = 100;   ///< Потеря оценки, с которой ход считается ошибкой
+    int blunderThreshold = 300;   ///< Потеря оценки, с которой ход считается грубой ошибкой
+    int mateClamp = 2000;         ///< Матовые оценки приравниваются к ±mateClamp при подсчёте потерь
+};
+
+/**
+ * @brief Разбор одного хода партии
+ */
+struct PlyAnalysis {
+    Move move;                ///< Сделанный ход
+    Move bestMove;            ///< Лучший ход по мнению движка
+    int scoreBefore = 0;      ///< Оценка позиции до хода с точки зрения ходившего
+    int scoreAfter = 0;       ///< Оценка позиции после хода с точки зрения ходившего
+    int loss = 0;             ///< Потеря оценки (не меньше 0)
+    MoveAnnotation annotation = MoveAnnotation::NONE;
+};
+
+/**
+ * @brief Разобрать партию
+ * @param start Начальная позиция
+ * @param moves Ходы партии
+ * @param options Настройки анализа
+ * @param table Таблица перестановок (может быть общей для нескольких потоков)
+ * @return Разбор каждого хода
+ * @throws std::invalid_argument если ход незаконен
+ *
+ * Позиции перебираются от последней к первой: к моменту анализа позиции
+ * таблица уже содержит оценки позиций, которые встретятся в её вариантах,
+ * и перебор заканчивается быстрее.
+ */
+inline std::vector<PlyAnalysis> analyzeGame(const Board& start, const std::vector<Move>& moves,
+                                            const AnalysisOptions& options, TranspositionTable& table) {
+    std::vector<Board> positions;
+    std::vector<std::uint64_t> keys;
+    positions.reserve(moves.size() + 1);
+    keys.reserve(moves.size() + 1);
+    positions.push_back(start);
+    for (Move move : moves) {
+        MoveList legal;
+        generateLegalMoves(positions.back(), legal);
+        if (std::find(legal.begin(), legal.end(), move) == legal.end()) {
+            throw std::invalid_argument("Незаконный ход в партии: " + moveToString(move));
+        }
+        keys.push_back(positions.back().getKey());
+        Board next = positions.back();
+        next.makeMove(move);
+        positions.push_back(next);
+    }
+
+    std::vector<SearchResult> results(positions.size());
+    Search search(options.limits);
+    search.setTranspositionTable(&table);
+    for (std::size_t i = positions.size(); i-- > 0; ) {
+        search.setHistory(std::vector<std::uint64_t>(keys.begin(), keys.begin() + i));
+        results[i] = search.run(positions[i]);
+    }
+
+    auto clamp = [&options](int score) { return std::max(-options.mateClamp, std::min(options.mateClamp, score)); };
+    std::vector<PlyAnalysis> analysis(moves.size());
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        PlyAnalysis& ply = analysis[i];
+        ply.move = moves[i];
+        ply.bestMove = results[i].bestMove;
+        ply.scoreBefore = results[i].score;
+        ply.scoreAfter = -results[i + 1].score;
+        ply.loss = ply.move == ply.bestMove ? 0 : std::max(0, clamp(ply.scoreBefore) - clamp(ply.scoreAfter));
+        ply.annotation = ply.loss >= options.blunderThreshold ? MoveAnnotation::BLUNDER
+                       : ply.loss >= options.mistakeThreshold ? MoveAnnotation::MISTAKE
+                       : MoveAnnotation::NONE;
+    }
+    return analysis;
+}
+
+/**
+ * @brief Партия для пакетного анализа
+ */
+struct GameToAnalyze {
+    Board start;
+    std::vector<Move> moves;
+};
+
+/**
+ * @brief Разобрать несколько партий параллельно
+ * @param games Партии
+ * @param options Настройки анализа
+ * @param pool Пул потоков: каждая партия — отдельная задача
+ * @param table Таблица перестановок, общая для всех потоков
+ * @return Разборы в порядке партий
+ * @throws std::invalid_argument если в какой-либо партии есть незаконный ход
+ */
+inline std::vector<std::vector<PlyAnalysis>> analyzeGames(const std::vector<GameToAnalyze>& games,
+                                                          const AnalysisOptions& options, ThreadPool& pool,
+                                                          TranspositionTable& table) {
+    std::vector<std::future<std::vector<PlyAnalysis>>> futures;
+    futures.reserve(games.size());
+    for (const GameToAnalyze& game : games) {
+        futures.push_back(pool.submit([&game, &options, &table]() {
+            return analyzeGame(game.start, game.moves, options, table);
+        }));
+    }
+    // Дожидаемся всех задач, даже если одна завершилась ошибкой: они ссылаются на аргументы
+    std::vector<std::vector<PlyAnalysis>> analyses;
+    analyses.reserve(games.size());
+    std::exception_ptr error;
+    for (auto& future : futures) {
+        try {
+            analyses.push_back(future.get());
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return analyses;
+}
+
+}
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef CHESS_ANALYSIS_SERVICE_H
+#define CHESS_ANALYSIS_SERVICE_H
+
+#include "packed.h"
+#include "search.h"
+#include "symmetry.h"
+#include "thread_pool.h"
+#include "tt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Состояние ответа службы анализа
+ */
+enum class AnalysisStatus : std::uint8_t {
+    OK = 0,      /**< Позиция проанализирована */
+    CACHED = 1,  /**< Ответ взят из кэша недавних результатов */
+    EXPIRED = 2, /**< Срок ответа истёк до начала анализа */
+    INVALID = 3  /**< Некорректная позиция или ограничения */
+};
+
+/**
+ * @brief Запрос анализа в двоичном протоколе (48 байт, little-endian)
+ *
+ * Позиция передаётся в упакованном виде: клиент переводит FEN через
+ * packPosition(), поэтому разбор текста не нагружает службу.
+ */
+struct AnalysisRequest {
+    std::uint32_t id = 0;          ///< Идентификатор запроса, возвращается в ответе
+    std::uint32_t nodes = 0;       ///< Лимит узлов (0 — без ограничения)
+    std::uint32_t deadlineMs = 0;  ///< Срок ответа от получения запроса (0 — без срока)
+    std::uint8_t depth = 0;        ///< Глубина перебора (1..MAX_PLY-1)
+    std::uint8_t reserved[3] = {}; ///< Зарезервировано (0)
+    PackedPosition position;       ///< Анализируемая позиция
+};
+
+static_assert(sizeof(AnalysisRequest) == 48, "Запрос анализа должен занимать 48 байт");
+
+/**
+ * @brief Ответ службы анализа (24 байта, little-endian)
+ */
+struct AnalysisReply {
+    std::uint64_t nodes = 0;       ///< Узлы перебора, давшего результат
+    std::uint32_t id = 0;          ///< Идентификатор запроса
+    std::int16_t score = 0;        ///< Оценка с точки зрения стороны, делающей ход
+    std::uint16_t move = 0;        ///< Лучший ход (Move::raw, 0 — ходов нет)
+    AnalysisStatus status = AnalysisStatus::OK;
+    std::uint8_t depth = 0;        ///< Глубина последней завершённой итерации
+    std::uint8_t reserved[6] = {}; ///< Зарезервировано (0)
+};
+
+static_assert(sizeof(AnalysisReply) == 24, "Ответ анализа должен занимать 24 байта");
+
+/**
+ * @brief Служба анализа позиций для многих клиентов
+ *
+ * Позиция приводится к канонической форме (symmetry.h), и запросы
+ * с одинаковыми каноническим ключом и ограничениями объединяются:
+ * пока позиция ждёт в очереди или анализируется, новые запросы только
+ * добавляются к её получателям; лучший ход переводится обратно для
+ * каждого получателя. Недавние результаты хранятся в кэше
+ * с вытеснением давно не использованных. Перебор идёт на общем пуле
+ * потоков с общей таблицей перестановок.
+ *
+ * Срок ответа проверяется при начале анализа: получатели с истёкшим сроком
+ * получают EXPIRED, а перебор ограничивается временем до самого позднего
+ * из оставшихся сроков.
+ */
+class AnalysisService {
+public:
+    using ReplyCallback = std::function<void(const AnalysisReply&)>;
+
+    /**
+     * @brief Счётчики работы службы
+     */
+    struct Stats {
+        std::uint64_t requests = 0;   ///< Всего запросов
+        std::uint64_t coalesced = 0;  ///< Присоединены к уже запланированному анализу
+        std::uint64_t cacheHits = 0;  ///< Получили ответ из кэша
+        std::uint64_t expired = 0;    ///< Получили EXPIRED
+        std::uint64_t searches = 0;   ///< Выполнено переборов
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct JobKey {
+        std::uint64_t key;
+        std::uint32_t nodes;
+        std::uint8_t depth;
+
+        bool operator==(const JobKey& other) const {
+            return key == other.key && nodes == other.nodes && depth == other.depth;
+        }
+    };
+
+    struct JobKeyHash {
+        std::size_t operator()(const JobKey& job) const {
+            return static_cast<std::size_t>(job.key ^ (std::uint64_t(job.nodes) * 0x9E3779B97F4A7C15ull)
+                                            ^ (std::uint64_t(job.depth) << 56));
+        }
+    };
+
+    struct Waiter {
+        std::uint32_t id;
+        int symmetry;   // переводит позицию запроса в анализируемую
+        bool hasDeadline;
+        Clock::time_point deadline;
+        ReplyCallback reply;
+    };
+
+    struct CachedResult {
+        SearchResult result;
+        std::list<JobKey>::iterator age;
+    };
+
+    ThreadPool& pool;
+    TranspositionTable table;
+    std::size_t cacheCapacity;
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::unordered_map<JobKey, std::vector<Waiter>, JobKeyHash> pending;
+    std::unordered_map<JobKey, CachedResult, JobKeyHash> cache;
+    std::list<JobKey> recent;   // в начале — последний использованный
+    std::size_t active;
+    Stats stats;
+
+    static AnalysisReply makeReply(std::uint32_t id, AnalysisStatus status, const SearchResult& result,
+                                   int symmetry = 0) {
+        AnalysisReply reply;
+        reply.id = id;
+        reply.status = status;
+        reply.nodes = result.nodes;
+        reply.score = static_cast<std::int16_t>(result.score);
+        reply.move = transformMove(result.bestMove, inverseSymmetry(symmetry)).raw();
+        reply.depth = static_cast<std::uint8_t>(result.depth);
+        return reply;
+    }
+
+    static bool isAnalyzable(const Board& board) {
+        return popCount(board.piecesOf(Color::WHITE, PieceKind::KING)) == 1
+            && popCount(board.piecesOf(Color::BLACK, PieceKind::KING)) == 1
+            && !board.inCheck(opposite(board.getSideToMove()));
+    }
+
+    void remember(const JobKey& job, const SearchResult& result) {
+        if (cacheCapacity == 0) {
+            return;
+        }
+        auto found = cache.find(job);
+        if (found != cache.end()) {
+            found->second.result = result;
+            recent.splice(recent.begin(), recent, found->second.age);
+            return;
+        }
+        if (cache.size() == cacheCapacity) {
+            cache.erase(recent.back());
+            recent.pop_back();
+        }
+        recent.push_front(job);
+        cache.emplace(job, CachedResult{result, recent.begin()});
+    }
+
+    void finishJob() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--active == 0) {
+            idle.notify_all();
+        }
+    }
+
+    void run(const JobKey& job, const Board& board) {
+        std::vector<Waiter> late;
+        SearchLimits limits;
+        limits.depth = job.depth;
+        limits.nodes = job.nodes;
+        bool empty;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<Waiter>& waiters = pending[job];
+            Clock::time_point now = Clock::now();
+            Clock::time_point latest = now;
+            bool unlimited = false;
+            auto expired = std::stable_partition(waiters.begin(), waiters.end(), [now](const Waiter& w) {
+                return !w.hasDeadline || w.deadline > now;
+            });
+            late.assign(std::make_move_iterator(expired), std::make_move_iterator(waiters.end()));
+            waiters.erase(expired, waiters.end());
+            for (const Waiter& w : waiters) {
+                if (!w.hasDeadline) unlimited = true;
+                else latest = std::max(latest, w.deadline);
+            }
+            if (!unlimited && !waiters.empty()) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(latest - now).count();
+                limits.timeMs = static_cast<int>(std::max<long long>(1, left));
+            }
+            stats.expired += late.size();
+            empty = waiters.empty();
+            if (empty) {
+                pending.erase(job);
+            }
+        }
+        for (const Waiter& w : late) {
+            w.reply(makeReply(w.id, AnalysisStatus::EXPIRED, SearchResult()));
+        }
+        if (empty) {
+            finishJob();
+            return;
+        }
+
+        Search search(limits);
+        search.setTranspositionTable(&table);
+        SearchResult result = search.run(board);
+
+        std::vector<Waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = pending.find(job);
+            waiters = std::move(found->second);
+            pending.erase(found);
+            ++stats.searches;
+            // Результат, обрезанный по времени, зависит от срока запроса и не кэшируется
+            if (limits.timeMs == 0 || result.depth >= job.depth) {
+                remember(job, result);
+            }
+        }
+        for (const Waiter& w : waiters) {
+            w.reply(makeReply(w.id, AnalysisStatus::OK, result, w.symmetry));
+        }
+        finishJob();
+    }
+
+public:
+    /**
+     * @brief Конструктор службы
+     * @param threadPool Пул потоков для переборов (должен жить дольше службы)
+     * @param hashMegabytes Размер общей таблицы перестановок
+     * @param cacheEntries Размер кэша недавних результатов (0 — без кэша)
+     */
+    explicit AnalysisService(ThreadPool& threadPool, std::size_t hashMegabytes = 64, std::size_t cacheEntries = 4096)
+    : pool(threadPool), table(hashMegabytes), cacheCapacity(cacheEntries), active(0) {}
+
+    AnalysisService(const AnalysisService&) = delete;
+    AnalysisService& operator=(const AnalysisService&) = delete;
+
+    /**
+     * @brief Деструктор: дожидается завершения всех запланированных переборов
+     */
+    ~AnalysisService() { wait(); }
+
+    /**
+     * @brief Принять запрос
+     * @param request Запрос
+     * @param reply Вызывается ровно один раз с ответом — сразу или из потока пула;
+     *              не должен бросать исключений
+     */
+    void submit(const AnalysisRequest& request, ReplyCallback reply) {
+        Board board;
+        bool valid = request.depth > 0 && request.depth < MAX_PLY;
+        if (valid) {
+            try {
+                board = unpackPosition(request.position);
+                valid = isAnalyzable(board);
+            } catch (const std::invalid_argument&) {
+                valid = false;
+            }
+        }
+        if (!valid) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++stats.requests;
+            }
+            reply(makeReply(request.id, AnalysisStatus::INVALID, SearchResult()));
+            return;
+        }
+
+        CanonicalPosition canonical = canonicalize(board);
+        if (canonical.symmetry != 0) {
+            board = transformBoard(board, canonical.symmetry);
+        }
+        JobKey job{canonical.key, request.nodes, request.depth};
+        Waiter waiter{request.id, canonical.symmetry, request.deadlineMs != 0,
+                      Clock::now() + std::chrono::milliseconds(request.deadlineMs), std::move(reply)};
+        SearchResult cached;
+        bool isCached = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.requests;
+            auto hit = cache.find(job);
+            if (hit != cache.end()) {
+                ++stats.cacheHits;
+                isCached = true;
+                recent.splice(recent.begin(), recent, hit->second.age);
+                cached = hit->second.result;
+            } else {
+                auto found = pending.find(job);
+                if (found != pending.end()) {
+                    ++stats.coalesced;
+                    found->second.push_back(std::move(waiter));
+                    return;
+                }
+                pending[job].push_back(std::move(waiter));
+                ++active;
+            }
+        }
+        if (isCached) {
+            waiter.reply(makeReply(request.id, AnalysisStatus::CACHED, cached, canonical.symmetry));
+            return;
+        }
+        pool.submit([this, job, board] { run(job, board); });
+    }
+
+    /**
+     * @brief Дождаться завершения всех запланированных переборов
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return active == 0; });
+    }
+
+    /**
+     * @brief Счётчики работы службы
+     * @return Копия счётчиков
+     */
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file analysisd.cpp
+ * @brief Служба анализа позиций на сокете Unix или TCP
+ *
+ * Один процесс с общим пулом потоков и общей таблицей перестановок
+ * обслуживает всех клиентов вместо отдельного процесса движка на каждый
+ * запрос. Протокол двоичный: клиент пишет в сокет 48-байтовые запросы
+ * AnalysisRequest, служба отвечает 24-байтовыми AnalysisReply по мере
+ * готовности (порядок ответов может отличаться от порядка запросов,
+ * сопоставление — по id). Одно соединение может передавать запросы
+ * без ожидания ответов.
+ *
+ * Режимы:
+ *   analysisd serve <адрес> [threads=N] [hash=MB] [cache=N]
+ *   analysisd query <адрес> [depth=N] [nodes=N] [deadline=MS] < позиции.fen
+ *
+ * Адрес — путь сокета Unix или хост:порт для TCP (":9000" — все интерфейсы).
+ * Службы на TCP служат рабочими процессами распределённого перебора cluster.
+ *
+ * В режиме query позиции читаются из стандартного ввода по одной FEN
+ * в строке, отправляются одним пакетом, ответы печатаются по мере прихода.
+ * SIGINT и SIGTERM останавливают службу после завершения начатых переборов.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread analysisd.cpp -o analysisd
+ */
+#include "analysis_service.h"
+#include "fen.h"
+#include "socket_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onStopSignal(int) { stopRequested = 1; }
+
+/**
+ * @brief Соединение с клиентом: ответы пишутся из потоков пула под мьютексом
+ */
+struct Connection {
+    int fd;
+    mutex writeMutex;
+
+    explicit Connection(int socket) : fd(socket) {}
+    ~Connection() { close(fd); }
+
+    void send(const Chess::AnalysisReply& reply) {
+        lock_guard<mutex> lock(writeMutex);
+        Chess::writeFully(fd, &reply, sizeof(reply));
+    }
+};
+
+/**
+ * @brief Потоки чтения соединений: счётчик работающих для остановки службы
+ */
+struct Readers {
+    mutex guard;
+    condition_variable finished;
+    size_t running = 0;
+    vector<weak_ptr<Connection>> connections;
+};
+
+void serveConnection(shared_ptr<Connection> connection, Chess::AnalysisService& service, Readers& readers) {
+    Chess::AnalysisRequest request;
+    while (Chess::readFully(connection->fd, &request, sizeof(request))) {
+        service.submit(request, [connection](const Chess::AnalysisReply& reply) { connection->send(reply); });
+    }
+    connection.reset();
+    lock_guard<mutex> lock(readers.guard);
+    if (--readers.running == 0) {
+        readers.finished.notify_all();
+    }
+}
+
+int serve(const string& path, unsigned threads, size_t hashMegabytes, size_t cacheEntries) {
+    int listener = Chess::listenOn(path);
+
+    // Без SA_RESTART сигнал прерывает accept()
+    struct sigaction action{};
+    action.sa_handler = onStopSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    Chess::ThreadPool pool(threads);
+    Chess::AnalysisService service(pool, hashMegabytes, cacheEntries);
+    Readers readers;
+    cerr << "Служба анализа слушает " << path << '\n';
+    while (!stopRequested) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Ошибка accept: " << strerror(errno) << '\n';
+            break;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));   // для сокета Unix не применяется
+        auto connection = make_shared<Connection>(fd);
+        {
+            lock_guard<mutex> lock(readers.guard);
+            auto& list = readers.connections;
+            list.erase(remove_if(list.begin(), list.end(), [](const weak_ptr<Connection>& c) { return c.expired(); }),
+                       list.end());
+            list.push_back(connection);
+            ++readers.running;
+        }
+        thread(serveConnection, move(connection), ref(service), ref(readers)).detach();
+    }
+
+    close(listener);
+    if (path.find(':') == string::npos) {
+        unlink(path.c_str());
+    }
+    {
+        unique_lock<mutex> lock(readers.guard);
+        for (const auto& weak : readers.connections) {
+            if (auto connection = weak.lock()) {
+                shutdown(connection->fd, SHUT_RD);
+            }
+        }
+        readers.finished.wait(lock, [&readers] { return readers.running == 0; });
+    }
+    service.wait();
+    Chess::AnalysisService::Stats stats = service.getStats();
+    cerr << "Запросов: " << stats.requests << ", объединено: " << stats.coalesced
+         << ", из кэша: " << stats.cacheHits << ", просрочено: " << stats.expired
+         << ", переборов: " << stats.searches << '\n';
+    return 0;
+}
+
+const char* statusName(Chess::AnalysisStatus status) {
+    switch (status) {
+        case Chess::AnalysisStatus::OK: return "ok";
+        case Chess::AnalysisStatus::CACHED: return "кэш";
+        case Chess::AnalysisStatus::EXPIRED: return "просрочен";
+        case Chess::AnalysisStatus::INVALID: return "ошибка";
+    }
+    return "?";
+}
+
+int query(const string& path, const Chess::AnalysisRequest& limits) {
+    vector<string> fens;
+    vector<Chess::AnalysisRequest> requests;
+    string line;
+    while (getline(cin, line)) {
+        if (line.empty()) continue;
+        Chess::AnalysisRequest request = limits;
+        request.id = static_cast<uint32_t>(fens.size());
+        request.position = Chess::packPosition(Chess::parseFen(line));
+        fens.push_back(line);
+        requests.push_back(request);
+    }
+
+    int fd = Chess::connectTo(path);
+    // Запросы пишутся отдельным потоком, чтобы ответы читались без ожидания конца отправки
+    thread writer([fd, &requests] {
+        Chess::writeFully(fd, requests.data(), requests.size() * sizeof(Chess::AnalysisRequest));
+    });
+    for (size_t received = 0; received < requests.size(); ++received) {
+        Chess::AnalysisReply reply;
+        if (!Chess::readFully(fd, &reply, sizeof(reply))) {
+            writer.join();
+            close(fd);
+            throw runtime_error("Соединение закрыто до получения всех ответов");
+        }
+        cout << reply.id << '\t' << statusName(reply.status) << '\t';
+        if (reply.status == Chess::AnalysisStatus::OK || reply.status == Chess::AnalysisStatus::CACHED) {
+            cout << Chess::moveToString(Chess::Move::fromRaw(reply.move)) << '\t' << reply.score << '\t'
+                 << int(reply.depth) << '\t' << reply.nodes << '\t';
+        }
+        cout << fens[reply.id] << '\n';
+    }
+    writer.join();
+    close(fd);
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || (string(argv[1]) != "serve" && string(argv[1]) != "query")) {
+        cerr << "Использование:\n"
+             << "  " << argv[0] << " serve <адрес> [threads=N] [hash=MB] [cache=N]\n"
+             << "  " << argv[0] << " query <адрес> [depth=N] [nodes=N] [deadline=MS] < позиции.fen\n";
+        return 1;
+    }
+    string mode = argv[1], path = argv[2];
+    unsigned threads = 0;
+    size_t hash = 64, cache = 4096;
+    Chess::AnalysisRequest limits;
+    limits.depth = 6;
+    try {
+        for (int i = 3; i < argc; ++i) {
+            string arg = argv[i];
+            size_t eq = arg.find('=');
+            string key = arg.substr(0, eq), value = eq == string::npos ? "" : arg.substr(eq + 1);
+            if (key == "threads") threads = stoul(value);
+            else if (key == "hash") hash = stoul(value);
+            else if (key == "cache") cache = stoul(value);
+            else if (key == "depth") limits.depth = static_cast<uint8_t>(stoi(value));
+            else if (key == "nodes") limits.nodes = stoul(value);
+            else if (key == "deadline") limits.deadlineMs = stoul(value);
+            else {
+                cerr << "Неизвестный параметр: " << key << '\n';
+                return 1;
+            }
+        }
+        return mode == "serve" ? serve(path, threads, hash, cache) : query(path, limits);
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+        return 1;
+    }
+}
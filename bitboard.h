@@ -0,0 +1,283 @@
+#ifndef CHESS_BITBOARD_H
+#define CHESS_BITBOARD_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Битовая доска: бит с номером клетки установлен, если клетка входит в множество
+ *
+ * Клетка с координатами (x, y) имеет номер y * 8 + x,
+ * то есть (0,0) — младший бит, (7,7) — старший.
+ */
+using Bitboard = std::uint64_t;
+
+constexpr int SQUARE_COUNT = 64;           ///< Количество клеток доски
+constexpr Bitboard RANK_FIRST = 0xFFULL;   ///< Горизонталь y = 0
+constexpr Bitboard RANK_LAST = 0xFFULL << 56; ///< Горизонталь y = 7
+
+/**
+ * @brief Проверить, что координаты лежат на доске
+ * @param x Координата X
+ * @param y Координата Y
+ * @return true если 0 <= x, y <= 7
+ */
+constexpr bool isOnBoard(int x, int y) { return x >= 0 && x <= 7 && y >= 0 && y <= 7; }
+
+/**
+ * @brief Получить номер клетки по координатам
+ * @param x Координата X (0-7)
+ * @param y Координата Y (0-7)
+ * @return Номер клетки (0-63)
+ */
+constexpr int makeSquare(int x, int y) { return y * 8 + x; }
+
+/**
+ * @brief Получить координату X клетки
+ * @param sq Номер клетки
+ * @return Координата X (0-7)
+ */
+constexpr int squareX(int sq) { return sq & 7; }
+
+/**
+ * @brief Получить координату Y клетки
+ * @param sq Номер клетки
+ * @return Координата Y (0-7)
+ */
+constexpr int squareY(int sq) { return sq >> 3; }
+
+/**
+ * @brief Битовая доска из одной клетки
+ * @param sq Номер клетки
+ * @return Множество, содержащее только клетку sq
+ */
+constexpr Bitboard squareBit(int sq) { return Bitboard(1) << sq; }
+
+/**
+ * @brief Количество клеток в множестве
+ * @param b Битовая доска
+ * @return Число установленных битов
+ */
+constexpr int popCount(Bitboard b) { return __builtin_popcountll(b); }
+
+/**
+ * @brief Младшая клетка множества
+ * @param b Непустая битовая доска
+ * @return Номер младшей установленной клетки
+ */
+constexpr int lowestSquare(Bitboard b) { return __builtin_ctzll(b); }
+
+/**
+ * @brief Извлечь младшую клетку из множества
+ * @param[in,out] b Непустая битовая доска, из которой удаляется клетка
+ * @return Номер извлечённой клетки
+ */
+constexpr int popLowestSquare(Bitboard& b) {
+    int sq = __builtin_ctzll(b);
+    b &= b - 1;
+    return sq;
+}
+
+namespace detail {
+
+/**
+ * @brief Построить таблицу атак фигуры с фиксированными шагами
+ * @param deltas Массив смещений {dx, dy}
+ * @return Таблица атак на пустой доске для каждой клетки
+ */
+template <std::size_t N>
+constexpr std::array<Bitboard, SQUARE_COUNT> makeStepAttacks(const int (&deltas)[N][2]) {
+    std::array<Bitboard, SQUARE_COUNT> table{};
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        for (std::size_t i = 0; i < N; ++i) {
+            int x = squareX(sq) + deltas[i][0];
+            int y = squareY(sq) + deltas[i][1];
+            if (isOnBoard(x, y)) {
+                table[sq] |= squareBit(makeSquare(x, y));
+            }
+        }
+    }
+    return table;
+}
+
+constexpr int KNIGHT_DELTAS[8][2] = {
+    {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
+    {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+};
+
+constexpr int KING_DELTAS[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+};
+
+/// Направления лучей: первые четыре увеличивают номер клетки, остальные уменьшают
+constexpr int RAY_DIRECTIONS[8][2] = {
+    {1, 0}, {0, 1}, {1, 1}, {-1, 1},
+    {-1, 0}, {0, -1}, {-1, -1}, {1, -1}
+};
+
+using RayTable = std::array<std::array<Bitboard, SQUARE_COUNT>, 8>;
+
+/**
+ * @brief Построить таблицу лучей на пустой доске
+ * @return Для каждого направления и клетки — клетки луча без самой клетки
+ */
+constexpr RayTable makeRays() {
+    RayTable rays{};
+    for (int d = 0; d < 8; ++d) {
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            int x = squareX(sq) + RAY_DIRECTIONS[d][0];
+            int y = squareY(sq) + RAY_DIRECTIONS[d][1];
+            for (; isOnBoard(x, y); x += RAY_DIRECTIONS[d][0], y += RAY_DIRECTIONS[d][1]) {
+                rays[d][sq] |= squareBit(makeSquare(x, y));
+            }
+        }
+    }
+    return rays;
+}
+
+inline constexpr RayTable RAYS = makeRays();
+
+/**
+ * @brief Атаки по одному лучу
+ * @param sq Клетка фигуры
+ * @param occupied Занятые клетки
+ * @param d Направление (индекс в RAY_DIRECTIONS)
+ * @return Клетки луча до первой занятой включительно
+ *
+ * Ближайшая занятая клетка — младший бит для растущих направлений и старший
+ * для убывающих; часть луча за ней отрезается её собственным лучом.
+ */
+constexpr Bitboard rayAttacks(int sq, Bitboard occupied, int d) {
+    Bitboard ray = RAYS[d][sq];
+    Bitboard blockers = ray & occupied;
+    if (blockers) {
+        ray ^= RAYS[d][d < 4 ? __builtin_ctzll(blockers) : 63 - __builtin_clzll(blockers)];
+    }
+    return ray;
+}
+
+} // namespace detail
+
+/// Атаки коня с каждой клетки
+inline constexpr std::array<Bitboard, SQUARE_COUNT> KNIGHT_ATTACKS =
+    detail::makeStepAttacks(detail::KNIGHT_DELTAS);
+
+/// Атаки короля с каждой клетки
+inline constexpr std::array<Bitboard, SQUARE_COUNT> KING_ATTACKS =
+    detail::makeStepAttacks(detail::KING_DELTAS);
+
+/**
+ * @brief Атаки ладьи
+ * @param sq Клетка ладьи
+ * @param occupied Занятые клетки
+ * @return Множество атакованных клеток
+ */
+constexpr Bitboard rookAttacks(int sq, Bitboard occupied) {
+    return detail::rayAttacks(sq, occupied, 0) | detail::rayAttacks(sq, occupied, 1)
+         | detail::rayAttacks(sq, occupied, 4) | detail::rayAttacks(sq, occupied, 5);
+}
+
+/**
+ * @brief Атаки слона
+ * @param sq Клетка слона
+ * @param occupied Занятые клетки
+ * @return Множество атакованных клеток
+ */
+constexpr Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    return detail::rayAttacks(sq, occupied, 2) | detail::rayAttacks(sq, occupied, 3)
+         | detail::rayAttacks(sq, occupied, 6) | detail::rayAttacks(sq, occupied, 7);
+}
+
+/**
+ * @brief Атаки ферзя
+ * @param sq Клетка ферзя
+ * @param occupied Занятые клетки
+ * @return Множество атакованных клеток
+ */
+constexpr Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+namespace detail {
+
+using SquarePairTable = std::array<std::array<Bitboard, SQUARE_COUNT>, SQUARE_COUNT>;
+
+/**
+ * @brief Построить таблицы клеток между парами клеток и линий через них
+ * @param lines false — клетки строго между, true — вся линия через обе клетки
+ * @return Таблица по парам клеток; для пар не на одной линии — пустое множество
+ */
+constexpr SquarePairTable makeSquarePairTable(bool lines) {
+    SquarePairTable table{};
+    for (int from = 0; from < SQUARE_COUNT; ++from) {
+        for (int d = 0; d < 8; ++d) {
+            int back = (d + 4) % 8;   // противоположное направление
+            Bitboard line = RAYS[d][from] | RAYS[back][from] | squareBit(from);
+            for (Bitboard b = RAYS[d][from]; b; ) {
+                int to = popLowestSquare(b);
+                table[from][to] = lines ? line : RAYS[d][from] & RAYS[back][to];
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace detail
+
+/// Клетки строго между двумя клетками одной горизонтали, вертикали или диагонали
+inline constexpr detail::SquarePairTable BETWEEN = detail::makeSquarePairTable(false);
+
+/// Вся линия (горизонталь, вертикаль или диагональ), проходящая через две клетки
+inline constexpr detail::SquarePairTable LINE = detail::makeSquarePairTable(true);
+
+/**
+ * @brief Обменять биты множества со сдвинутыми на delta
+ * @param b Битовая доска
+ * @param mask Младшие биты обмениваемых пар
+ * @param delta Расстояние между битами пары
+ * @return Битовая доска, где бит i из mask поменялся местами с битом i + delta
+ */
+constexpr Bitboard deltaSwap(Bitboard b, Bitboard mask, int delta) {
+    Bitboard t = (b ^ (b >> delta)) & mask;
+    return b ^ t ^ (t << delta);
+}
+
+/**
+ * @brief Отразить доску сверху вниз: (x, y) -> (x, 7 - y)
+ * @param b Битовая доска
+ * @return Отражённая доска (перестановка байтов)
+ */
+constexpr Bitboard flipVertical(Bitboard b) { return __builtin_bswap64(b); }
+
+/**
+ * @brief Отразить доску слева направо: (x, y) -> (7 - x, y)
+ * @param b Битовая доска
+ * @return Отражённая доска
+ */
+constexpr Bitboard mirrorHorizontal(Bitboard b) {
+    b = deltaSwap(b, 0x5555555555555555ULL, 1);
+    b = deltaSwap(b, 0x3333333333333333ULL, 2);
+    return deltaSwap(b, 0x0F0F0F0F0F0F0F0FULL, 4);
+}
+
+/**
+ * @brief Отразить доску относительно диагонали a1-h8: (x, y) -> (y, x)
+ * @param b Битовая доска
+ * @return Отражённая доска
+ */
+constexpr Bitboard flipDiagonal(Bitboard b) {
+    b = deltaSwap(b, 0x00000000F0F0F0F0ULL, 28);
+    b = deltaSwap(b, 0x0000CCCC0000CCCCULL, 14);
+    return deltaSwap(b, 0x00AA00AA00AA00AAULL, 7);
+}
+
+}
+
+#endif
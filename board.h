@@ -0,0 +1,675 @@
+#ifndef CHESS_BOARD_H
+#define CHESS_BOARD_H
+
+#include "a.h"
+#include "bitboard.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Вид фигуры на битовой доске
+ *
+ * Соответствует конкретным классам иерархии ChessPiece.
+ */
+enum class PieceKind {
+    KNIGHT, /**< Конь */
+    BISHOP, /**< Слон */
+    ROOK,   /**< Ладья */
+    QUEEN,  /**< Ферзь */
+    KING    /**< Король */
+};
+
+constexpr int PIECE_KIND_COUNT = 5; ///< Количество видов фигур
+constexpr int COLOR_COUNT = 2;      ///< Количество цветов
+constexpr int POCKET_LIMIT = 16;    ///< Максимум фигур одного вида в кармане
+
+/**
+ * @brief Индекс цвета для таблиц
+ * @param col Цвет
+ * @return 0 для белых, 1 для чёрных
+ */
+constexpr int colorIndex(Color col) { return col == Color::WHITE ? 0 : 1; }
+
+/**
+ * @brief Противоположный цвет
+ * @param col Цвет
+ * @return Цвет соперника
+ */
+constexpr Color opposite(Color col) { return col == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+/**
+ * @brief Определить вид фигуры иерархии
+ * @param piece Фигура
+ * @return Вид фигуры
+ * @throws std::invalid_argument если фигура не относится к конкретным классам
+ */
+inline PieceKind kindOf(const ChessPiece& piece) {
+    if (dynamic_cast<const Knight*>(&piece)) return PieceKind::KNIGHT;
+    if (dynamic_cast<const Bishop*>(&piece)) return PieceKind::BISHOP;
+    if (dynamic_cast<const Rook*>(&piece)) return PieceKind::ROOK;
+    if (dynamic_cast<const Queen*>(&piece)) return PieceKind::QUEEN;
+    if (dynamic_cast<const King*>(&piece)) return PieceKind::KING;
+    throw std::invalid_argument("Неизвестный вид фигуры");
+}
+
+/**
+ * @brief Атаки фигуры заданного вида
+ * @param kind Вид фигуры
+ * @param sq Клетка фигуры
+ * @param occupied Занятые клетки
+ * @return Множество атакованных клеток
+ */
+inline Bitboard pieceAttacks(PieceKind kind, int sq, Bitboard occupied) {
+    switch (kind) {
+    case PieceKind::KNIGHT: return KNIGHT_ATTACKS[sq];
+    case PieceKind::BISHOP: return bishopAttacks(sq, occupied);
+    case PieceKind::ROOK:   return rookAttacks(sq, occupied);
+    case PieceKind::QUEEN:  return queenAttacks(sq, occupied);
+    case PieceKind::KING:   return KING_ATTACKS[sq];
+    }
+    return 0;
+}
+
+/**
+ * @brief Ход, упакованный в 16 бит
+ *
+ * Биты 0-5 — исходная клетка, 6-11 — целевая клетка,
+ * 12-15 — вид сбрасываемой фигуры плюс один (0 для обычного хода).
+ */
+class Move {
+private:
+    std::uint16_t data;
+
+    constexpr explicit Move(std::uint16_t raw) : data(raw) {}
+
+public:
+    /**
+     * @brief Пустой ход
+     */
+    constexpr Move() : data(0) {}
+
+    /**
+     * @brief Обычный ход фигуры
+     * @param from Исходная клетка
+     * @param to Целевая клетка
+     * @return Упакованный ход
+     */
+    static constexpr Move normal(int from, int to) {
+        return Move(static_cast<std::uint16_t>(from | (to << 6)));
+    }
+
+    /**
+     * @brief Сброс фигуры из кармана
+     * @param kind Вид фигуры
+     * @param to Целевая клетка
+     * @return Упакованный ход
+     */
+    static constexpr Move drop(PieceKind kind, int to) {
+        return Move(static_cast<std::uint16_t>((to << 6) | ((static_cast<int>(kind) + 1) << 12)));
+    }
+
+    /**
+     * @brief Восстановить ход из упакованного значения
+     * @param raw Значение, полученное от raw()
+     * @return Ход
+     */
+    static constexpr Move fromRaw(std::uint16_t raw) { return Move(raw); }
+
+    constexpr int from() const { return data & 63; }
+    constexpr int to() const { return (data >> 6) & 63; }
+    constexpr bool isDrop() const { return (data >> 12) != 0; }
+    constexpr PieceKind dropKind() const { return static_cast<PieceKind>((data >> 12) - 1); }
+    constexpr bool isNone() const { return data == 0; }
+    constexpr std::uint16_t raw() const { return data; }
+
+    constexpr bool operator==(Move other) const { return data == other.data; }
+    constexpr bool operator!=(Move other) const { return data != other.data; }
+};
+
+namespace detail {
+
+/**
+ * @brief Шаг генератора SplitMix64 для построения ключей Зобриста
+ */
+constexpr std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Случайные ключи Зобриста для хэширования позиции
+ */
+struct ZobristKeys {
+    std::uint64_t piece[COLOR_COUNT][PIECE_KIND_COUNT][SQUARE_COUNT];
+    std::uint64_t pocket[COLOR_COUNT][PIECE_KIND_COUNT][POCKET_LIMIT + 1];
+    std::uint64_t side;
+};
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    std::uint64_t state = 0x4368657373ULL;
+    for (int c = 0; c < COLOR_COUNT; ++c)
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k)
+            for (int sq = 0; sq < SQUARE_COUNT; ++sq)
+                keys.piece[c][k][sq] = splitMix64(state);
+    // Пустой карман не меняет ключ, поэтому pocket[..][..][0] остаётся нулём
+    for (int c = 0; c < COLOR_COUNT; ++c)
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k)
+            for (int n = 1; n <= POCKET_LIMIT; ++n)
+                keys.pocket[c][k][n] = splitMix64(state);
+    keys.side = splitMix64(state);
+    return keys;
+}
+
+} // namespace detail
+
+/// Ключи Зобриста, вычисленные на этапе компиляции
+inline constexpr detail::ZobristKeys ZOBRIST = detail::makeZobristKeys();
+
+/**
+ * @brief Шахматная доска на битовых досках
+ *
+ * Хранит расположение фигур по цветам и видам, очередь хода,
+ * карманы для вариантов со сбросом фигур (crazyhouse) и ключ Зобриста,
+ * который обновляется инкрементально при каждом изменении.
+ *
+ * Так же инкрементально ведутся карты атак: для каждого цвета — число
+ * фигур, атакующих каждую клетку (защищённые свои фигуры тоже считаются
+ * атакованными). Числа хранятся по разрядам: битовая доска i содержит
+ * разряд i числа для всех клеток сразу, поэтому прибавить единицу к целому
+ * множеству клеток — несколько логических операций без цикла по клеткам.
+ * Когда фигура ставится, снимается или переходит, пересчитываются атаки
+ * только самой фигуры и тех дальнобойных фигур, чьи лучи проходят через
+ * затронутые клетки, а проверка шаха и атакованности клетки сводится
+ * к чтению битовой доски.
+ */
+class Board {
+public:
+    /**
+     * @brief Вариант правил
+     */
+    enum class Variant {
+        STANDARD,  /**< Классические шахматы */
+        CRAZYHOUSE /**< Взятые фигуры попадают в карман и могут быть сброшены */
+    };
+
+private:
+    Bitboard pieces[COLOR_COUNT][PIECE_KIND_COUNT];
+    Bitboard colorPieces[COLOR_COUNT];
+    std::int8_t squares[SQUARE_COUNT];   ///< -1 для пустой клетки, иначе цвет * 5 + вид
+    std::uint8_t pocket[COLOR_COUNT][PIECE_KIND_COUNT];
+    Color sideToMove;
+    Variant variant;
+    std::uint64_t key;
+    /// Разряды числа атакующих: клетку бьют не больше 8 коней и 8 лучей, то есть до 16 фигур
+    static constexpr int ATTACK_BITS = 5;
+    Bitboard attackCounts[COLOR_COUNT][ATTACK_BITS]; ///< Разряды числа фигур цвета, атакующих клетку
+    int halfmoveClock;   ///< Полуходы без взятий (правило 50 ходов)
+    int fullmoveNumber;  ///< Номер хода, растёт после хода чёрных
+
+    void checkSquare(int sq) const {
+        if (sq < 0 || sq >= SQUARE_COUNT) {
+            throw std::invalid_argument("Номер клетки должен быть в диапазоне 0-63");
+        }
+    }
+
+    /// Прибавить единицу к числу атакующих на клетках targets (сложение с переносом по разрядам)
+    void addAttacks(int c, Bitboard targets) {
+        for (int i = 0; i < ATTACK_BITS && targets; ++i) {
+            Bitboard carry = attackCounts[c][i] & targets;
+            attackCounts[c][i] ^= targets;
+            targets = carry;
+        }
+    }
+
+    /// Вычесть единицу из числа атакующих на клетках targets (вычитание с заёмом)
+    void removeAttacks(int c, Bitboard targets) {
+        for (int i = 0; i < ATTACK_BITS && targets; ++i) {
+            Bitboard borrow = ~attackCounts[c][i] & targets;
+            attackCounts[c][i] ^= targets;
+            targets = borrow;
+        }
+    }
+
+    /**
+     * @brief Обновить атаки дальнобойных фигур, чьи лучи проходят через клетку
+     * @param sq Клетка, которая становится занятой или пустой (сейчас на ней фигуры нет)
+     * @param blocking true если клетка занимается: лучи за ней обрываются
+     * @param occupiedSquares Занятые клетки без sq
+     *
+     * Такие фигуры — это слоны, ладьи и ферзи, атакующие sq. Меняется только
+     * часть луча за sq: клетки линии LINE[p][sq], которые атакует из sq
+     * фигура того же вида, кроме клеток между p и sq и самой p.
+     */
+    void updateRaysThrough(int sq, bool blocking, Bitboard occupiedSquares) {
+        Bitboard orthogonal = rookAttacks(sq, occupiedSquares);
+        Bitboard diagonal = bishopAttacks(sq, occupiedSquares);
+        Bitboard queens = pieces[0][3] | pieces[1][3];
+        Bitboard sliders = (orthogonal & (pieces[0][2] | pieces[1][2] | queens))
+                         | (diagonal & (pieces[0][1] | pieces[1][1] | queens));
+        while (sliders) {
+            int from = popLowestSquare(sliders);
+            Bitboard rays = (orthogonal & squareBit(from)) ? orthogonal : diagonal;
+            Bitboard beyond = rays & LINE[from][sq] & ~(BETWEEN[from][sq] | squareBit(from));
+            int c = squares[from] / PIECE_KIND_COUNT;
+            if (blocking) {
+                removeAttacks(c, beyond);
+            } else {
+                addAttacks(c, beyond);
+            }
+        }
+    }
+
+    /**
+     * @brief Переставить фигуру, взяв фигуру соперника на целевой клетке, если она есть
+     *
+     * В отличие от снятия и постановки фигуры лучи через целевую клетку
+     * при взятии не пересчитываются (клетка остаётся занятой), а атаки
+     * самой фигуры обновляются только на разнице старого и нового множеств.
+     */
+    void movePiece(int from, int to) {
+        int c = squares[from] / PIECE_KIND_COUNT;
+        int k = squares[from] % PIECE_KIND_COUNT;
+        PieceKind kind = static_cast<PieceKind>(k);
+        Bitboard before = pieceAttacks(kind, from, occupied());
+        bool capture = squares[to] >= 0;
+        if (capture) {
+            int capturedColor = squares[to] / PIECE_KIND_COUNT;
+            int captured = squares[to] % PIECE_KIND_COUNT;
+            removeAttacks(capturedColor, pieceAttacks(static_cast<PieceKind>(captured), to, occupied()));
+            pieces[capturedColor][captured] &= ~squareBit(to);
+            colorPieces[capturedColor] &= ~squareBit(to);
+            key ^= ZOBRIST.piece[capturedColor][captured][to];
+        }
+        pieces[c][k] &= ~squareBit(from);
+        colorPieces[c] &= ~squareBit(from);
+        squares[from] = -1;
+        key ^= ZOBRIST.piece[c][k][from];
+        // Целевая клетка считается занятой при взятии и пустой при тихом ходе
+        Bitboard occupiedSquares = occupied() | (capture ? squareBit(to) : 0);
+        updateRaysThrough(from, false, occupiedSquares);
+        if (!capture) {
+            updateRaysThrough(to, true, occupiedSquares);
+        }
+        pieces[c][k] |= squareBit(to);
+        colorPieces[c] |= squareBit(to);
+        squares[to] = static_cast<std::int8_t>(c * PIECE_KIND_COUNT + k);
+        key ^= ZOBRIST.piece[c][k][to];
+        Bitboard after = pieceAttacks(kind, to, occupied());
+        removeAttacks(c, before & ~after);
+        addAttacks(c, after & ~before);
+    }
+
+    void setPocket(Color col, PieceKind kind, int count) {
+        int c = colorIndex(col);
+        int k = static_cast<int>(kind);
+        key ^= ZOBRIST.pocket[c][k][pocket[c][k]] ^ ZOBRIST.pocket[c][k][count];
+        pocket[c][k] = static_cast<std::uint8_t>(count);
+    }
+
+public:
+    /**
+     * @brief Конструктор пустой доски
+     * @param rules Вариант правил
+     *
+     * Создаёт доску без фигур с ходом белых.
+     */
+    explicit Board(Variant rules = Variant::STANDARD)
+    : pieces{}, colorPieces{}, pocket{}, sideToMove(Color::WHITE), variant(rules), key(0),
+      attackCounts{}, halfmoveClock(0), fullmoveNumber(1) {
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            squares[sq] = -1;
+        }
+    }
+
+    /**
+     * @brief Поставить фигуру на клетку
+     * @param col Цвет фигуры
+     * @param kind Вид фигуры
+     * @param sq Номер клетки
+     * @throws std::invalid_argument если клетка занята или вне доски
+     */
+    void putPiece(Color col, PieceKind kind, int sq) {
+        checkSquare(sq);
+        if (squares[sq] >= 0) {
+            throw std::invalid_argument("Клетка уже занята");
+        }
+        int c = colorIndex(col);
+        int k = static_cast<int>(kind);
+        updateRaysThrough(sq, true, occupied());
+        pieces[c][k] |= squareBit(sq);
+        colorPieces[c] |= squareBit(sq);
+        squares[sq] = static_cast<std::int8_t>(c * PIECE_KIND_COUNT + k);
+        key ^= ZOBRIST.piece[c][k][sq];
+        addAttacks(c, pieceAttacks(kind, sq, occupied()));
+    }
+
+    /**
+     * @brief Поставить на доску фигуру из иерархии ChessPiece
+     * @param piece Фигура, её цвет и позиция берутся из объекта
+     */
+    void putPiece(const ChessPiece& piece) {
+        int posX, posY;
+        piece.getPosition(posX, posY);
+        putPiece(piece.getColor(), kindOf(piece), makeSquare(posX, posY));
+    }
+
+    /**
+     * @brief Убрать фигуру с клетки
+     * @param sq Номер клетки
+     * @throws std::invalid_argument если клетка пуста
+     */
+    void removePiece(int sq) {
+        checkSquare(sq);
+        if (squares[sq] < 0) {
+            throw std::invalid_argument("Клетка пуста");
+        }
+        int c = squares[sq] / PIECE_KIND_COUNT;
+        int k = squares[sq] % PIECE_KIND_COUNT;
+        removeAttacks(c, pieceAttacks(static_cast<PieceKind>(k), sq, occupied()));
+        pieces[c][k] &= ~squareBit(sq);
+        colorPieces[c] &= ~squareBit(sq);
+        squares[sq] = -1;
+        key ^= ZOBRIST.piece[c][k][sq];
+        updateRaysThrough(sq, false, occupied());
+    }
+
+    /**
+     * @brief Проверить, пуста ли клетка
+     * @param sq Номер клетки
+     * @return true если на клетке нет фигуры
+     */
+    bool isEmpty(int sq) const { return squares[sq] < 0; }
+
+    /**
+     * @brief Цвет фигуры на клетке
+     * @param sq Номер занятой клетки
+     * @return Цвет фигуры
+     */
+    Color colorAt(int sq) const {
+        return squares[sq] < PIECE_KIND_COUNT ? Color::WHITE : Color::BLACK;
+    }
+
+    /**
+     * @brief Вид фигуры на клетке
+     * @param sq Номер занятой клетки
+     * @return Вид фигуры
+     */
+    PieceKind kindAt(int sq) const {
+        return static_cast<PieceKind>(squares[sq] % PIECE_KIND_COUNT);
+    }
+
+    /**
+     * @brief Все занятые клетки
+     * @return Битовая доска занятых клеток
+     */
+    Bitboard occupied() const { return colorPieces[0] | colorPieces[1]; }
+
+    /**
+     * @brief Фигуры заданного цвета
+     * @param col Цвет
+     * @return Битовая доска фигур цвета
+     */
+    Bitboard piecesOf(Color col) const { return colorPieces[colorIndex(col)]; }
+
+    /**
+     * @brief Фигуры заданного цвета и вида
+     * @param col Цвет
+     * @param kind Вид фигуры
+     * @return Битовая доска фигур
+     */
+    Bitboard piecesOf(Color col, PieceKind kind) const {
+        return pieces[colorIndex(col)][static_cast<int>(kind)];
+    }
+
+    /**
+     * @brief Получить сторону, которая делает ход
+     * @return Цвет стороны
+     */
+    Color getSideToMove() const { return sideToMove; }
+
+    /**
+     * @brief Установить сторону, которая делает ход
+     * @param col Цвет стороны
+     */
+    void setSideToMove(Color col) {
+        if (col != sideToMove) {
+            sideToMove = col;
+            key ^= ZOBRIST.side;
+        }
+    }
+
+    /**
+     * @brief Получить вариант правил
+     * @return Вариант правил доски
+     */
+    Variant getVariant() const { return variant; }
+    
+    /**
+     * @brief Счётчик полуходов без взятий
+     * @return Количество полуходов
+     */
+    int getHalfmoveClock() const { return halfmoveClock; }
+    
+    /**
+     * @brief Номер текущего хода партии
+     * @return Номер хода (начиная с 1)
+     */
+    int getFullmoveNumber() const { return fullmoveNumber; }
+    
+    /**
+     * @brief Установить счётчики ходов
+     * @param halfmoves Полуходы без взятий
+     * @param fullmoves Номер хода
+     * @throws std::invalid_argument если значения отрицательны или номер хода меньше 1
+     */
+    void setMoveCounters(int halfmoves, int fullmoves) {
+        if (halfmoves < 0 || fullmoves < 1) {
+            throw std::invalid_argument("Некорректные счётчики ходов");
+        }
+        halfmoveClock = halfmoves;
+        fullmoveNumber = fullmoves;
+    }
+    
+    /**
+     * @brief Клетка короля заданного цвета
+     * @param col Цвет
+     * @return Номер клетки или -1, если короля нет на доске
+     */
+    int kingSquare(Color col) const {
+        Bitboard king = piecesOf(col, PieceKind::KING);
+        return king ? lowestSquare(king) : -1;
+    }
+    
+    /**
+     * @brief Все фигуры, атакующие клетку
+     * @param sq Номер клетки
+     * @param occupiedSquares Занятые клетки, блокирующие лучи
+     * @return Битовая доска атакующих фигур обоих цветов
+     */
+    Bitboard attackersTo(int sq, Bitboard occupiedSquares) const {
+        Bitboard knights = pieces[0][0] | pieces[1][0];
+        Bitboard bishops = pieces[0][1] | pieces[1][1];
+        Bitboard rooks = pieces[0][2] | pieces[1][2];
+        Bitboard queens = pieces[0][3] | pieces[1][3];
+        Bitboard kings = pieces[0][4] | pieces[1][4];
+        return (KNIGHT_ATTACKS[sq] & knights)
+             | (KING_ATTACKS[sq] & kings)
+             | (bishopAttacks(sq, occupiedSquares) & (bishops | queens))
+             | (rookAttacks(sq, occupiedSquares) & (rooks | queens));
+    }
+    
+    /**
+     * @brief Проверить, атакована ли клетка фигурами цвета
+     * @param sq Номер клетки
+     * @param by Цвет атакующей стороны
+     * @return true если хотя бы одна фигура цвета by бьёт клетку
+     */
+    bool isAttacked(int sq, Color by) const {
+        return (attackedBy(by) & squareBit(sq)) != 0;
+    }
+
+    /**
+     * @brief Клетки, атакованные фигурами цвета
+     * @param by Цвет атакующей стороны
+     * @return Битовая доска атакованных клеток (включая клетки своих фигур)
+     */
+    Bitboard attackedBy(Color by) const {
+        const Bitboard* counts = attackCounts[colorIndex(by)];
+        return counts[0] | counts[1] | counts[2] | counts[3] | counts[4];
+    }
+
+    /**
+     * @brief Число фигур цвета, атакующих клетку
+     * @param sq Номер клетки
+     * @param by Цвет атакующей стороны
+     * @return Количество атакующих фигур
+     */
+    int attackerCount(int sq, Color by) const {
+        int count = 0;
+        for (int i = 0; i < ATTACK_BITS; ++i) {
+            count |= static_cast<int>((attackCounts[colorIndex(by)][i] >> sq) & 1) << i;
+        }
+        return count;
+    }
+    
+    /**
+     * @brief Проверить, находится ли король стороны под шахом
+     * @param col Цвет короля
+     * @return true если король под шахом (false, если короля нет)
+     */
+    bool inCheck(Color col) const {
+        int sq = kingSquare(col);
+        return sq >= 0 && isAttacked(sq, opposite(col));
+    }
+
+    /**
+     * @brief Ключ Зобриста позиции
+     * @return 64-битный хэш с учётом фигур, карманов и очереди хода
+     */
+    std::uint64_t getKey() const { return key; }
+
+    /**
+     * @brief Количество фигур вида в кармане
+     * @param col Цвет владельца кармана
+     * @param kind Вид фигуры
+     * @return Количество фигур
+     */
+    int getPocketCount(Color col, PieceKind kind) const {
+        return pocket[colorIndex(col)][static_cast<int>(kind)];
+    }
+
+    /**
+     * @brief Положить фигуру в карман
+     * @param col Цвет владельца кармана
+     * @param kind Вид фигуры
+     * @throws std::logic_error если это король или карман переполнен
+     */
+    void addToPocket(Color col, PieceKind kind) {
+        if (kind == PieceKind::KING) {
+            throw std::logic_error("Король не может находиться в кармане");
+        }
+        int count = getPocketCount(col, kind);
+        if (count >= POCKET_LIMIT) {
+            throw std::logic_error("Карман переполнен");
+        }
+        setPocket(col, kind, count + 1);
+    }
+
+    /**
+     * @brief Клетки, на которые можно сбросить фигуру вида
+     * @param kind Вид фигуры
+     * @return Множество допустимых клеток
+     *
+     * Все фигуры иерархии, кроме короля, сбрасываются на любую пустую клетку:
+     * ограничения по крайним горизонталям действуют только для пешек.
+     */
+    Bitboard dropTargets(PieceKind kind) const {
+        if (kind == PieceKind::KING) {
+            return 0;
+        }
+        return ~occupied();
+    }
+
+    /**
+     * @brief Сгенерировать все сбросы стороны, делающей ход
+     * @param[out] moves Массив для ходов (не менее 4 * 64 элементов)
+     * @return Количество записанных ходов
+     *
+     * Множество целевых клеток вычисляется один раз на вид фигуры,
+     * поэтому генерация не перебирает клетки по одной.
+     */
+    int generateDrops(Move* moves) const {
+        int count = 0;
+        int c = colorIndex(sideToMove);
+        for (int k = 0; k < static_cast<int>(PieceKind::KING); ++k) {
+            if (pocket[c][k] == 0) {
+                continue;
+            }
+            PieceKind kind = static_cast<PieceKind>(k);
+            Bitboard targets = dropTargets(kind);
+            while (targets) {
+                moves[count++] = Move::drop(kind, popLowestSquare(targets));
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Выполнить ход
+     * @param move Обычный ход или сброс
+     * @throws std::invalid_argument если ход не соответствует позиции
+     *
+     * При взятии в варианте CRAZYHOUSE взятая фигура попадает в карман
+     * взявшей стороны. Законность хода относительно правил движения не проверяется.
+     */
+    void makeMove(Move move) {
+        // Проверки идут до первого изменения: после исключения позиция прежняя
+        int to = move.to();
+        if (move.isDrop()) {
+            PieceKind kind = move.dropKind();
+            int count = getPocketCount(sideToMove, kind);
+            if (count == 0 || !(dropTargets(kind) & squareBit(to))) {
+                throw std::invalid_argument("Невозможный сброс фигуры");
+            }
+            ++halfmoveClock;
+            setPocket(sideToMove, kind, count - 1);
+            putPiece(sideToMove, kind, to);
+        } else {
+            int from = move.from();
+            if (squares[from] < 0 || colorAt(from) != sideToMove) {
+                throw std::invalid_argument("На исходной клетке нет фигуры стороны, делающей ход");
+            }
+            if (squares[to] >= 0) {
+                if (colorAt(to) == sideToMove) {
+                    throw std::invalid_argument("Нельзя взять свою фигуру");
+                }
+                PieceKind captured = kindAt(to);
+                if (variant == Variant::CRAZYHOUSE && captured != PieceKind::KING) {
+                    addToPocket(sideToMove, captured);   // при переполнении бросает, ничего не меняя
+                }
+                halfmoveClock = 0;
+            } else {
+                ++halfmoveClock;
+            }
+            movePiece(from, to);
+        }
+        if (sideToMove == Color::BLACK) {
+            ++fullmoveNumber;
+        }
+        setSideToMove(opposite(sideToMove));
+    }
+};
+
+}
+
+#endif
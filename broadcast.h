@@ -0,0 +1,333 @@
+#ifndef CHESS_BROADCAST_H
+#define CHESS_BROADCAST_H
+
+#include "game_server.h"
+#include "packed.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Изменение позиции одним ходом, упакованное в 64 бита
+ *
+ * Биты 0-31 — номер хода в трансляции (с 1), 32-47 — ход (Move::raw),
+ * 48-51 — вид взятой фигуры плюс один (0 — без взятия), 52 — шах,
+ * 53 — партия завершена, 54-55 — итог (0 — победа белых, 1 — ничья,
+ * 2 — победа чёрных). В сокет записываются 8 байт в порядке little-endian.
+ */
+struct MoveDelta {
+    std::uint32_t sequence = 0;
+    Move move;
+    int captured = -1;
+    bool check = false;
+    bool finished = false;
+    GameResult result = GameResult::DRAW;
+
+    /**
+     * @brief Упаковать изменение
+     * @return 64-битное слово
+     */
+    std::uint64_t pack() const {
+        return std::uint64_t(sequence)
+             | (std::uint64_t(move.raw()) << 32)
+             | (std::uint64_t(captured + 1) << 48)
+             | (std::uint64_t(check) << 52)
+             | (std::uint64_t(finished) << 53)
+             | (std::uint64_t(static_cast<int>(result)) << 54);
+    }
+
+    /**
+     * @brief Распаковать изменение
+     * @param word 64-битное слово, полученное от pack()
+     * @return Изменение
+     */
+    static MoveDelta unpack(std::uint64_t word) {
+        MoveDelta delta;
+        delta.sequence = static_cast<std::uint32_t>(word);
+        delta.move = Move::fromRaw(static_cast<std::uint16_t>(word >> 32));
+        delta.captured = static_cast<int>((word >> 48) & 15) - 1;
+        delta.check = (word >> 52) & 1;
+        delta.finished = (word >> 53) & 1;
+        delta.result = static_cast<GameResult>((word >> 54) & 3);
+        return delta;
+    }
+};
+
+/**
+ * @brief Канал трансляции одной партии
+ *
+ * Один писатель (поток, обрабатывающий ходы партии) кодирует каждый ход
+ * один раз в кольцевой буфер; любое число зрителей читает его без
+ * блокировок в своём темпе. Ячейка буфера — одно атомарное слово, в котором
+ * записан номер хода, поэтому зритель сразу видит, что ячейку уже
+ * перезаписали. Отставший зритель восстанавливается по снимку последней
+ * позиции, защищённому seqlock. Поддерживаются позиции классического варианта.
+ */
+class BroadcastChannel {
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> ring;
+    std::size_t mask;
+    std::atomic<std::uint32_t> published;
+    std::atomic<std::uint32_t> snapshotVersion;
+    std::atomic<std::uint64_t> snapshotWords[4];
+    std::atomic<std::uint32_t> snapshotSequence;
+
+    void storeSnapshot(const Board& board, std::uint32_t sequence) {
+        PackedPosition packed = packPosition(board);
+        std::uint32_t version = snapshotVersion.load(std::memory_order_relaxed);
+        snapshotVersion.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int w = 0; w < 4; ++w) {
+            std::uint64_t word;
+            std::memcpy(&word, packed.bytes.data() + 8 * w, 8);
+            snapshotWords[w].store(word, std::memory_order_relaxed);
+        }
+        snapshotSequence.store(sequence, std::memory_order_relaxed);
+        snapshotVersion.store(version + 2, std::memory_order_release);
+    }
+
+public:
+    /**
+     * @brief Создать канал
+     * @param start Начальная позиция партии
+     * @param capacity Ёмкость кольцевого буфера (степень двойки)
+     * @throws std::invalid_argument если ёмкость не степень двойки или позиция не классического варианта
+     */
+    explicit BroadcastChannel(const Board& start, std::size_t capacity = 256)
+    : ring(new std::atomic<std::uint64_t>[capacity]), mask(capacity - 1), published(0),
+      snapshotVersion(0), snapshotSequence(0) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("Ёмкость канала должна быть степенью двойки");
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            ring[i].store(0, std::memory_order_relaxed);
+        }
+        storeSnapshot(start, 0);
+    }
+
+    BroadcastChannel(const BroadcastChannel&) = delete;
+    BroadcastChannel& operator=(const BroadcastChannel&) = delete;
+
+    /**
+     * @brief Опубликовать ход (только поток-писатель)
+     * @param delta Изменение; номер назначается каналом
+     * @param after Позиция после хода (для снимка)
+     * @return Номер опубликованного хода
+     */
+    std::uint32_t publish(MoveDelta delta, const Board& after) {
+        delta.sequence = published.load(std::memory_order_relaxed) + 1;
+        ring[delta.sequence & mask].store(delta.pack(), std::memory_order_release);
+        storeSnapshot(after, delta.sequence);
+        published.store(delta.sequence, std::memory_order_release);
+        return delta.sequence;
+    }
+
+    /**
+     * @brief Номер последнего опубликованного хода
+     * @return 0, если ходов ещё не было
+     */
+    std::uint32_t lastSequence() const { return published.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Прочитать ход из буфера
+     * @param sequence Номер хода
+     * @param[out] delta Изменение
+     * @return false если ход ещё не опубликован или уже вытеснен из буфера
+     */
+    bool read(std::uint32_t sequence, MoveDelta& delta) const {
+        std::uint64_t word = ring[sequence & mask].load(std::memory_order_acquire);
+        if (static_cast<std::uint32_t>(word) != sequence || sequence == 0) {
+            return false;
+        }
+        delta = MoveDelta::unpack(word);
+        return true;
+    }
+
+    /**
+     * @brief Прочитать снимок последней позиции
+     * @param[out] board Позиция
+     * @return Номер хода, после которого сделан снимок
+     */
+    std::uint32_t snapshot(Board& board) const {
+        PackedPosition packed;
+        std::uint32_t sequence;
+        for (;;) {
+            std::uint32_t before = snapshotVersion.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            for (int w = 0; w < 4; ++w) {
+                std::uint64_t word = snapshotWords[w].load(std::memory_order_relaxed);
+                std::memcpy(packed.bytes.data() + 8 * w, &word, 8);
+            }
+            sequence = snapshotSequence.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (snapshotVersion.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        board = unpackPosition(packed);
+        return sequence;
+    }
+};
+
+/**
+ * @brief Зритель партии: копия позиции, обновляемая по трансляции
+ */
+class Spectator {
+private:
+    std::shared_ptr<const BroadcastChannel> channel;
+    Board board;
+    std::uint32_t next;
+    std::size_t catchUps;
+
+    void catchUp() {
+        next = channel->snapshot(board) + 1;
+        ++catchUps;
+    }
+
+public:
+    /**
+     * @brief Подписаться на канал
+     * @param source Канал партии
+     *
+     * Зритель начинает со снимка текущей позиции.
+     */
+    explicit Spectator(std::shared_ptr<const BroadcastChannel> source)
+    : channel(std::move(source)), next(0), catchUps(0) {
+        next = channel->snapshot(board) + 1;
+    }
+
+    /**
+     * @brief Прочитать опубликованные ходы
+     * @param onDelta Вызывается для каждого применённого хода: onDelta(const MoveDelta&, const Board&)
+     * @return Количество применённых ходов
+     *
+     * Если зритель отстал больше чем на ёмкость буфера, позиция
+     * восстанавливается по снимку, а пропущенные ходы не сообщаются.
+     */
+    template <class OnDelta>
+    std::size_t poll(OnDelta&& onDelta) {
+        std::size_t applied = 0;
+        std::uint32_t last = channel->lastSequence();
+        while (next <= last) {
+            MoveDelta delta;
+            if (!channel->read(next, delta)) {
+                catchUp();
+                last = channel->lastSequence();
+                continue;
+            }
+            board.makeMove(delta.move);
+            ++next;
+            ++applied;
+            onDelta(delta, static_cast<const Board&>(board));
+        }
+        return applied;
+    }
+
+    /**
+     * @brief Прочитать опубликованные ходы без обработчика
+     * @return Количество применённых ходов
+     */
+    std::size_t poll() {
+        return poll([](const MoveDelta&, const Board&) {});
+    }
+
+    const Board& position() const { return board; }
+    std::uint32_t getSequence() const { return next - 1; }
+    std::size_t getCatchUpCount() const { return catchUps; }
+};
+
+/**
+ * @brief Каналы трансляции всех партий сервера
+ *
+ * publish() подходит как обработчик GameManager::setMoveListener:
+ * в канал попадают только принятые ходы.
+ */
+class SpectatorHub {
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<GameId, std::shared_ptr<BroadcastChannel>> channels;
+    std::size_t capacity;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param channelCapacity Ёмкость буфера каждого канала (степень двойки)
+     */
+    explicit SpectatorHub(std::size_t channelCapacity = 256) : capacity(channelCapacity) {}
+
+    /**
+     * @brief Открыть канал партии
+     * @param id Идентификатор партии
+     * @param start Начальная позиция
+     */
+    void open(GameId id, const Board& start) {
+        auto channel = std::make_shared<BroadcastChannel>(start, capacity);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        channels[id] = std::move(channel);
+    }
+
+    /**
+     * @brief Закрыть канал партии (подписанные зрители сохраняют к нему доступ)
+     * @param id Идентификатор партии
+     */
+    void close(GameId id) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        channels.erase(id);
+    }
+
+    /**
+     * @brief Канал партии для подписки
+     * @param id Идентификатор партии
+     * @return Канал или пустой указатель
+     */
+    std::shared_ptr<const BroadcastChannel> channel(GameId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto found = channels.find(id);
+        return found == channels.end() ? nullptr : found->second;
+    }
+
+    /**
+     * @brief Опубликовать обработанный ход
+     * @param event Событие менеджера партий
+     * @param after Позиция после обработки
+     */
+    void publish(const MoveEvent& event, const Board& after) {
+        if (event.outcome != MoveOutcome::ACCEPTED) {
+            return;
+        }
+        std::shared_ptr<BroadcastChannel> target;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto found = channels.find(event.game);
+            if (found == channels.end()) {
+                return;
+            }
+            target = found->second;
+        }
+        MoveDelta delta;
+        delta.move = event.move;
+        delta.captured = event.captured;
+        delta.check = event.check;
+        delta.finished = event.finished;
+        delta.result = event.result;
+        target->publish(delta, after);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef CHESS_BULK_WRITER_H
+#define CHESS_BULK_WRITER_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Буферизованный вывод большими блоками через write(2)
+ *
+ * Текст формируется прямо в буфере писателя функциями вида format*(char*, ...),
+ * которые возвращают указатель за последним символом: reserve() даёт место,
+ * commit() фиксирует записанное. Системный вызов делается, только когда
+ * буфер заполнен, при flush() и в деструкторе, поэтому вывод миллионов
+ * позиций не упирается в сброс потока на каждой строке.
+ *
+ * Не синхронизирован с std::cout: перед выводом в тот же дескриптор
+ * поток нужно сбросить.
+ */
+class BulkWriter {
+private:
+    int fd;
+    std::vector<char> buffer;
+    std::size_t used;
+
+public:
+    /**
+     * @brief Конструктор
+     * @param descriptor Дескриптор файла (1 — стандартный вывод)
+     * @param capacity Размер буфера в байтах
+     */
+    explicit BulkWriter(int descriptor = 1, std::size_t capacity = 1 << 20)
+    : fd(descriptor), buffer(capacity), used(0) {}
+
+    BulkWriter(const BulkWriter&) = delete;
+    BulkWriter& operator=(const BulkWriter&) = delete;
+
+    /**
+     * @brief Деструктор: записывает остаток буфера (ошибки записи игнорируются)
+     */
+    ~BulkWriter() {
+        try {
+            flush();
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    /**
+     * @brief Записать буфер в дескриптор
+     * @throws std::runtime_error при ошибке записи
+     */
+    void flush() {
+        const char* p = buffer.data();
+        std::size_t left = used;
+        used = 0;
+        while (left > 0) {
+            ssize_t n = ::write(fd, p, left);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                throw std::runtime_error(std::string("Ошибка записи: ") + std::strerror(errno));
+            }
+            p += n;
+            left -= static_cast<std::size_t>(n);
+        }
+    }
+
+    /**
+     * @brief Получить место под текст
+     * @param size Наибольшая длина текста
+     * @return Указатель, по которому можно записать size байт
+     *
+     * Если текст длиннее буфера, буфер увеличивается.
+     */
+    char* reserve(std::size_t size) {
+        if (buffer.size() - used < size) {
+            flush();
+            if (buffer.size() < size) {
+                buffer.resize(size);
+            }
+        }
+        return buffer.data() + used;
+    }
+
+    /**
+     * @brief Зафиксировать текст, записанный после reserve()
+     * @param end Указатель за последним записанным символом
+     */
+    void commit(const char* end) { used = static_cast<std::size_t>(end - buffer.data()); }
+
+    /**
+     * @brief Добавить строку
+     * @param text Текст
+     */
+    void append(std::string_view text) {
+        char* out = reserve(text.size());
+        std::memcpy(out, text.data(), text.size());
+        commit(out + text.size());
+    }
+
+    /**
+     * @brief Добавить символ
+     * @param c Символ
+     */
+    void put(char c) {
+        char* out = reserve(1);
+        *out = c;
+        commit(out + 1);
+    }
+};
+
+}
+
+#endif
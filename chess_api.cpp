@@ -0,0 +1,212 @@
+/**
+ * @file chess_api.cpp
+ * @brief Реализация интерфейса на C поверх заголовков движка
+ *
+ * Сборка: g++ -std=c++17 -O2 -fPIC -shared -pthread chess_api.cpp -o libchess.so
+ */
+#include "chess_api.h"
+
+#include "datagen.h"
+#include "fen.h"
+#include "packed.h"
+#include "search.h"
+#include "thread_pool.h"
+#include "tt.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static_assert(sizeof(chess_position) == sizeof(Chess::PackedPosition), "Размер chess_position должен совпадать с PackedPosition");
+static_assert(sizeof(chess_search_result) == 16, "chess_search_result должен занимать 16 байт");
+
+struct chess_board {
+    Chess::Board board;
+};
+
+namespace {
+
+thread_local string lastError;
+
+int fail(int code, const string& message) {
+    lastError = message;
+    return code;
+}
+
+/**
+ * @brief Выполнить тело функции интерфейса, переводя исключения в коды ошибок
+ */
+template <class Body>
+int guarded(Body&& body) {
+    try {
+        return body();
+    } catch (const invalid_argument& e) {
+        return fail(CHESS_ERROR_INVALID, e.what());
+    } catch (const exception& e) {
+        return fail(CHESS_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(CHESS_ERROR_INTERNAL, "Неизвестная ошибка");
+    }
+}
+
+Chess::Board unpack(const chess_position& position, size_t index) {
+    Chess::PackedPosition packed;
+    memcpy(packed.bytes.data(), position.bytes, sizeof(position.bytes));
+    try {
+        return Chess::unpackPosition(packed);
+    } catch (const invalid_argument& e) {
+        throw invalid_argument("Позиция " + to_string(index) + ": " + e.what());
+    }
+}
+
+}
+
+extern "C" {
+
+int chess_api_version(void) { return CHESS_API_VERSION; }
+
+const char* chess_last_error(void) { return lastError.c_str(); }
+
+chess_board* chess_board_new(const char* fen) {
+    chess_board* result = nullptr;
+    guarded([&] {
+        auto created = make_unique<chess_board>();
+        created->board = Chess::parseFen(fen ? fen : Chess::PAWNLESS_START_FEN);
+        result = created.release();
+        return 0;
+    });
+    return result;
+}
+
+void chess_board_free(chess_board* board) { delete board; }
+
+int chess_board_fen(const chess_board* board, char* out, size_t capacity) {
+    if (!board || !out) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    char buffer[Chess::FEN_MAX_LENGTH];
+    size_t length = static_cast<size_t>(Chess::formatFen(buffer, board->board) - buffer);
+    if (length + 1 > capacity) {
+        return fail(CHESS_ERROR_CAPACITY, "Буфер FEN мал: нужно " + to_string(length + 1) + " байт");
+    }
+    memcpy(out, buffer, length);
+    out[length] = '\0';
+    return static_cast<int>(length);
+}
+
+int chess_board_pack(const chess_board* board, chess_position* out) {
+    if (!board || !out) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    return guarded([&] {
+        Chess::PackedPosition packed = Chess::packPosition(board->board);
+        memcpy(out->bytes, packed.bytes.data(), sizeof(out->bytes));
+        return 0;
+    });
+}
+
+int chess_board_make_move(chess_board* board, uint16_t move) {
+    if (!board) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    Chess::Move candidate = Chess::Move::fromRaw(move);
+    if (!Chess::isPseudoLegal(board->board, candidate) || !Chess::isLegal(board->board, candidate)) {
+        return fail(CHESS_ERROR_INVALID, "Незаконный ход " + Chess::moveToString(candidate));
+    }
+    board->board.makeMove(candidate);
+    return 0;
+}
+
+int chess_board_legal_moves(const chess_board* board, uint16_t* moves, size_t capacity) {
+    if (!board || (!moves && capacity > 0)) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    Chess::MoveList list;
+    Chess::generateLegalMoves(board->board, list);
+    if (static_cast<size_t>(list.size) > capacity) {
+        return fail(CHESS_ERROR_CAPACITY, "Нужно места на " + to_string(list.size) + " ходов");
+    }
+    for (int i = 0; i < list.size; ++i) {
+        moves[i] = list[i].raw();
+    }
+    return list.size;
+}
+
+int chess_move_to_string(uint16_t move, char* out, size_t capacity) {
+    if (!out) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    if (capacity < Chess::MOVE_TEXT_MAX + 1) {
+        return fail(CHESS_ERROR_CAPACITY, "Буфер хода мал");
+    }
+    char* end = Chess::formatMove(out, Chess::Move::fromRaw(move));
+    *end = '\0';
+    return static_cast<int>(end - out);
+}
+
+int chess_gen_moves_batch(const chess_position* positions, size_t count,
+                          uint16_t* moves, size_t capacity, uint32_t* offsets) {
+    if ((!positions && count > 0) || !offsets || (!moves && capacity > 0)) {
+        return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    }
+    return guarded([&] {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            offsets[i] = static_cast<uint32_t>(total);
+            Chess::MoveList list;
+            Chess::generateLegalMoves(unpack(positions[i], i), list);
+            // Когда место кончилось, продолжаем только считать, чтобы сообщить нужную ёмкость
+            if (total + static_cast<size_t>(list.size) <= capacity) {
+                for (int m = 0; m < list.size; ++m) {
+                    moves[total + m] = list[m].raw();
+                }
+            }
+            total += static_cast<size_t>(list.size);
+        }
+        offsets[count] = static_cast<uint32_t>(total);
+        if (total > capacity) {
+            return fail(CHESS_ERROR_CAPACITY, "Нужно места на " + to_string(total) + " ходов");
+        }
+        return static_cast<int>(total);
+    });
+}
+
+int chess_search(const chess_position* positions, size_t count,
+                 const chess_search_limits* limits, chess_search_result* results) {
+    if ((!positions || !results) && count > 0) return fail(CHESS_ERROR_INVALID, "Пустой указатель");
+    if (!limits) return fail(CHESS_ERROR_INVALID, "Не заданы ограничения перебора");
+    return guarded([&] {
+        vector<Chess::Board> boards;
+        boards.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            boards.push_back(unpack(positions[i], i));
+        }
+        Chess::SearchLimits searchLimits;
+        if (limits->depth > 0) searchLimits.depth = min(limits->depth, Chess::MAX_PLY - 1);
+        searchLimits.nodes = limits->nodes;
+        searchLimits.timeMs = limits->time_ms;
+        unique_ptr<Chess::TranspositionTable> table;
+        if (limits->hash_mb > 0) {
+            table = make_unique<Chess::TranspositionTable>(limits->hash_mb);
+        }
+
+        Chess::ThreadPool pool(static_cast<unsigned>(min<size_t>(limits->threads ? limits->threads : thread::hardware_concurrency(),
+                                                                 max<size_t>(count, 1))));
+        vector<future<void>> futures;
+        futures.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            futures.push_back(pool.submit([&, i] {
+                Chess::Search search(searchLimits);
+                search.setTranspositionTable(table.get());
+                Chess::SearchResult result = search.run(boards[i]);
+                results[i].nodes = result.nodes;
+                results[i].best_move = result.bestMove.raw();
+                results[i].score = static_cast<int16_t>(result.score);
+                results[i].depth = result.depth;
+            }));
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+        return static_cast<int>(count);
+    });
+}
+
+}
@@ -0,0 +1,116 @@
+/**
+ * @file chess_api.h
+ * @brief Стабильный интерфейс на C для встраивания движка (Python, Go и др.)
+ *
+ * Библиотека собирается из chess_api.cpp:
+ *   g++ -std=c++17 -O2 -fPIC -shared -pthread chess_api.cpp -o libchess.so
+ * Клиент на C, проверяющий интерфейс, — chess_api_test.c.
+ *
+ * Все функции возвращают неотрицательное значение при успехе и один из
+ * кодов CHESS_ERROR_* при ошибке; текст последней ошибки потока даёт
+ * chess_last_error(). Исключения C++ через границу не проходят.
+ *
+ * Позиции в пакетных вызовах передаются массивами 32-байтовых структур
+ * chess_position (формат PackedPosition из packed.h), ходы — 16-битными
+ * числами (Move::raw из board.h). Один вызов обрабатывает сразу много
+ * позиций, чтобы стоимость перехода через FFI делилась на весь пакет.
+ */
+#ifndef CHESS_API_H
+#define CHESS_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHESS_API_VERSION 1
+
+#define CHESS_ERROR_INVALID  (-1) /**< Некорректные аргументы, позиция или ход */
+#define CHESS_ERROR_CAPACITY (-2) /**< Выходной массив слишком мал */
+#define CHESS_ERROR_INTERNAL (-3) /**< Непредвиденная ошибка внутри библиотеки */
+
+/** Позиция, упакованная в 32 байта (классический вариант) */
+typedef struct chess_position {
+    uint8_t bytes[32];
+} chess_position;
+
+/** Ограничения перебора */
+typedef struct chess_search_limits {
+    int32_t depth;      /**< Глубина в полуходах (0 — без ограничения) */
+    int32_t time_ms;    /**< Время на позицию в мс (0 — без ограничения) */
+    uint64_t nodes;     /**< Узлов на позицию (0 — без ограничения) */
+    uint32_t threads;   /**< Потоков для пакета (0 — по числу ядер) */
+    uint32_t hash_mb;   /**< Общая таблица перестановок в МБ (0 — без таблицы) */
+} chess_search_limits;
+
+/** Результат перебора одной позиции */
+typedef struct chess_search_result {
+    uint64_t nodes;     /**< Рассмотрено узлов */
+    uint16_t best_move; /**< Лучший ход (0 — ходов нет) */
+    int16_t score;      /**< Оценка с точки зрения стороны, делающей ход */
+    int32_t depth;      /**< Глубина последней завершённой итерации */
+} chess_search_result;
+
+/** Непрозрачная доска */
+typedef struct chess_board chess_board;
+
+/** Версия интерфейса (CHESS_API_VERSION, с которой собрана библиотека) */
+int chess_api_version(void);
+
+/** Текст последней ошибки в текущем потоке (пустая строка, если ошибок не было) */
+const char* chess_last_error(void);
+
+/**
+ * Создать доску из FEN (NULL — начальная расстановка без пешек).
+ * Возвращает NULL при ошибке.
+ */
+chess_board* chess_board_new(const char* fen);
+
+/** Освободить доску (NULL допускается) */
+void chess_board_free(chess_board* board);
+
+/**
+ * Записать FEN доски с завершающим нулём.
+ * Возвращает длину строки или CHESS_ERROR_CAPACITY.
+ */
+int chess_board_fen(const chess_board* board, char* out, size_t capacity);
+
+/** Упаковать доску (только классический вариант) */
+int chess_board_pack(const chess_board* board, chess_position* out);
+
+/** Сделать ход, если он законен */
+int chess_board_make_move(chess_board* board, uint16_t move);
+
+/** Законные ходы доски; возвращает их число или CHESS_ERROR_CAPACITY */
+int chess_board_legal_moves(const chess_board* board, uint16_t* moves, size_t capacity);
+
+/**
+ * Записать ход в координатной нотации с завершающим нулём ("e2e4", "N@e4").
+ * Буфера в 8 байт достаточно всегда.
+ */
+int chess_move_to_string(uint16_t move, char* out, size_t capacity);
+
+/**
+ * Законные ходы для пакета позиций.
+ * Ходы позиции i записываются в moves[offsets[i] .. offsets[i + 1]).
+ * offsets должен вмещать count + 1 элементов. Если moves мал, возвращается
+ * CHESS_ERROR_CAPACITY, а offsets[count] содержит нужную ёмкость.
+ * При успехе возвращает общее число ходов.
+ */
+int chess_gen_moves_batch(const chess_position* positions, size_t count,
+                          uint16_t* moves, size_t capacity, uint32_t* offsets);
+
+/**
+ * Перебор пакета позиций на пуле потоков; results вмещает count элементов.
+ * Возвращает count или код ошибки (при некорректной позиции — её индекс в тексте ошибки).
+ */
+int chess_search(const chess_position* positions, size_t count,
+                 const chess_search_limits* limits, chess_search_result* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file chess_api_test.c
+ * @brief Проверка интерфейса на C: клиент, собранный против libchess.so
+ *
+ * Сборка и запуск:
+ *   g++ -std=c++17 -O2 -fPIC -shared -pthread chess_api.cpp -o libchess.so
+ *   gcc -std=c99 -Wall -Wextra chess_api_test.c -L. -lchess -Wl,-rpath,. -o chess_api_test
+ *   ./chess_api_test
+ *
+ * Файл написан на C, чтобы заодно проверить, что chess_api.h
+ * компилируется без C++.
+ */
+#include "chess_api.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+static void check(int condition, const char* what) {
+    if (!condition) {
+        printf("!!! ОШИБКА: %s (последняя ошибка: %s)\n", what, chess_last_error());
+        ++failures;
+    }
+}
+
+/* Упаковать позицию из FEN */
+static void pack(const char* fen, chess_position* out) {
+    chess_board* board = chess_board_new(fen);
+    check(board != NULL, "FEN не разобран");
+    check(board && chess_board_pack(board, out) >= 0, "Позиция не упакована");
+    chess_board_free(board);
+}
+
+/* Пакетная генерация ходов, включая нехватку места */
+static void testGenMovesBatch(void) {
+    chess_position positions[2];
+    uint32_t offsets[3];
+    uint16_t moves[256];
+    uint16_t small[4];
+    int total, needed;
+
+    pack(NULL, &positions[0]);
+    pack("4k3/8/8/8/8/8/8/R3K3 w - - 0 1", &positions[1]);
+
+    total = chess_gen_moves_batch(positions, 2, moves, 256, offsets);
+    printf("Ходов в пакете: %d (%u + %u)\n", total, offsets[1] - offsets[0], offsets[2] - offsets[1]);
+    check(total > 0 && offsets[0] == 0 && offsets[2] == (uint32_t)total, "Смещения пакета неверны");
+
+    /* Мал буфер: код ошибки, а offsets[count] — нужная ёмкость */
+    memset(offsets, 0, sizeof(offsets));
+    needed = chess_gen_moves_batch(positions, 2, small, 4, offsets);
+    printf("Буфер на 4 хода: код %d, нужно %u\n", needed, offsets[2]);
+    check(needed == CHESS_ERROR_CAPACITY, "Нехватка места не сообщена");
+    check(offsets[2] == (uint32_t)total, "Нужная ёмкость не записана в offsets[count]");
+}
+
+/* Перебор без ограничения глубины и с некорректной позицией */
+static void testSearch(void) {
+    chess_position positions[2];
+    chess_search_result results[2];
+    chess_search_limits limits;
+    int code;
+
+    pack("4k3/8/8/8/8/8/8/R3K3 w - - 0 1", &positions[0]);
+    memset(&limits, 0, sizeof(limits));
+    limits.depth = 0;
+    limits.nodes = 20000;
+    limits.threads = 1;
+    code = chess_search(positions, 1, &limits, results);
+    printf("Перебор с depth = 0: код %d, глубина %d, узлов %llu\n", code, (int)results[0].depth,
+           (unsigned long long)results[0].nodes);
+    check(code == 1 && results[0].depth > 0 && results[0].best_move != 0, "Перебор без лимита глубины не выполнен");
+
+    /* Вторая позиция испорчена: в тексте ошибки её индекс */
+    memset(&positions[1], 0xFF, sizeof(positions[1]));
+    code = chess_search(positions, 2, &limits, results);
+    printf("Некорректная позиция: код %d, %s\n", code, chess_last_error());
+    check(code == CHESS_ERROR_INVALID, "Некорректная позиция не отклонена");
+    check(strstr(chess_last_error(), "Позиция 1") != NULL, "В тексте ошибки нет индекса позиции");
+}
+
+int main(void) {
+    check(chess_api_version() == CHESS_API_VERSION, "Версия библиотеки не совпадает с заголовком");
+    testGenMovesBatch();
+    testSearch();
+    if (failures) {
+        return 1;
+    }
+    printf("ИНТЕРФЕЙС C ПРОВЕРЕН\n");
+    return 0;
+}
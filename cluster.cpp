@@ -0,0 +1,76 @@
+/**
+ * @file cluster.cpp
+ * @brief Координатор распределённого перебора
+ *
+ * Делит ходы корня между службами анализа, запущенными на этой или других
+ * машинах (analysisd serve хост:порт), и объединяет их оценки. Позиции
+ * читаются из стандартного ввода по одной FEN в строке.
+ *
+ * Пример на одной машине:
+ *   analysisd serve 127.0.0.1:9001 threads=2 &
+ *   analysisd serve 127.0.0.1:9002 threads=2 &
+ *   cluster 127.0.0.1:9001 127.0.0.1:9002 depth=7 < позиции.fen
+ *
+ * Параметры: depth (по умолчанию 6), time — лимит на позицию в мс,
+ * window — запросов на рабочего одновременно.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread cluster.cpp -o cluster
+ */
+#include "cluster.h"
+#include "fen.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    vector<string> addresses;
+    Chess::SearchLimits limits;
+    limits.depth = 6;
+    int window = 2;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            size_t eq = arg.find('=');
+            if (eq == string::npos) {
+                addresses.push_back(arg);
+                continue;
+            }
+            string key = arg.substr(0, eq), value = arg.substr(eq + 1);
+            if (key == "depth") limits.depth = stoi(value);
+            else if (key == "time") limits.timeMs = stoi(value);
+            else if (key == "window") window = stoi(value);
+            else {
+                cerr << "Неизвестный параметр: " << key << '\n';
+                return 1;
+            }
+        }
+        if (addresses.empty()) {
+            cerr << "Использование: " << argv[0] << " <рабочий>... [depth=N] [time=MS] [window=N] < позиции.fen\n";
+            return 1;
+        }
+
+        Chess::ClusterSearch cluster(addresses, window);
+        cout << "Рабочих: " << cluster.workerCount() << '\n';
+        string line;
+        while (getline(cin, line)) {
+            if (line.empty()) continue;
+            Chess::Board board = Chess::parseFen(line);
+            auto begin = chrono::steady_clock::now();
+            Chess::SearchResult result = cluster.run(board, limits, [](const Chess::SearchResult& r) {
+                cout << "  глубина " << r.depth << ": " << Chess::moveToString(r.bestMove)
+                     << " оценка " << r.score << " узлов " << r.nodes << '\n';
+            });
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            cout << line << "\n  лучший ход " << Chess::moveToString(result.bestMove) << ", оценка " << result.score
+                 << ", " << result.nodes << " узлов за " << seconds << " с\n";
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
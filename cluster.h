@@ -0,0 +1,249 @@
+#ifndef CHESS_CLUSTER_H
+#define CHESS_CLUSTER_H
+
+#include "analysis_service.h"
+#include "movegen.h"
+#include "packed.h"
+#include "search.h"
+#include "socket_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Перебор с разделением ходов корня между рабочими процессами
+ *
+ * Рабочие — службы анализа (analysisd serve) на одной или нескольких
+ * машинах. На каждой итерации углубления координатор рассылает позиции
+ * после каждого хода корня как запросы AnalysisRequest с глубиной на
+ * единицу меньше и собирает оценки. Ходы раздаются по мере освобождения
+ * рабочих (не более window запросов на рабочего), начиная с лучших по
+ * предыдущей итерации, поэтому медленные машины не задерживают остальных.
+ * Таблица перестановок у каждого рабочего своя и переживает итерации.
+ *
+ * Дети корня перебираются с полным окном и без истории партии:
+ * повторения, начавшиеся до корня, не распознаются. Запросы рабочего,
+ * разорвавшего соединение, передаются остальным.
+ */
+class ClusterSearch {
+private:
+    struct Worker {
+        int fd;
+        std::vector<int> outstanding;   // индексы ходов корня в обработке
+    };
+
+    std::vector<Worker> workers;
+    int window;
+
+    void dropWorker(Worker& worker, std::deque<int>& queue) {
+        close(worker.fd);
+        worker.fd = -1;
+        for (int index : worker.outstanding) {
+            queue.push_front(index);
+        }
+        worker.outstanding.clear();
+    }
+
+    /**
+     * @brief Одна итерация: оценить все ходы корня на глубине childDepth
+     * @return false если итерация прервана сроком
+     */
+    bool iterate(const std::vector<PackedPosition>& children, const std::vector<int>& order, int childDepth,
+                 const std::chrono::steady_clock::time_point* deadline,
+                 std::vector<int>& scores, std::uint64_t& nodes) {
+        std::deque<int> queue(order.begin(), order.end());
+        std::size_t done = 0;
+        bool expired = false;
+        while (done < children.size()) {
+            int remainingMs = 0;
+            if (deadline) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    *deadline - std::chrono::steady_clock::now()).count();
+                if (left <= 0) expired = true;
+                remainingMs = static_cast<int>(std::max<long long>(1, left));
+            }
+            bool alive = false;
+            for (Worker& worker : workers) {
+                if (worker.fd < 0) continue;
+                alive = true;
+                while (!expired && !queue.empty() && static_cast<int>(worker.outstanding.size()) < window) {
+                    int index = queue.front();
+                    AnalysisRequest request;
+                    request.id = static_cast<std::uint32_t>(index);
+                    request.depth = static_cast<std::uint8_t>(childDepth);
+                    request.deadlineMs = static_cast<std::uint32_t>(remainingMs);
+                    request.position = children[index];
+                    if (!writeFully(worker.fd, &request, sizeof(request))) {
+                        dropWorker(worker, queue);
+                        break;
+                    }
+                    queue.pop_front();
+                    worker.outstanding.push_back(index);
+                }
+            }
+            if (!alive) {
+                throw std::runtime_error("Все рабочие процессы отключились");
+            }
+
+            std::vector<pollfd> fds;
+            std::vector<Worker*> owners;
+            for (Worker& worker : workers) {
+                if (worker.fd >= 0 && !worker.outstanding.empty()) {
+                    fds.push_back(pollfd{worker.fd, POLLIN, 0});
+                    owners.push_back(&worker);
+                }
+            }
+            if (fds.empty()) {
+                if (expired) return false;
+                continue;   // запросы отключившегося рабочего вернулись в очередь
+            }
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Ошибка ожидания ответов рабочих");
+            }
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                if (!fds[i].revents) continue;
+                Worker& worker = *owners[i];
+                AnalysisReply reply;
+                if (!readFully(worker.fd, &reply, sizeof(reply))) {
+                    dropWorker(worker, queue);
+                    continue;
+                }
+                auto it = std::find(worker.outstanding.begin(), worker.outstanding.end(), static_cast<int>(reply.id));
+                if (it == worker.outstanding.end()) {
+                    throw std::runtime_error("Ответ рабочего на неизвестный запрос");
+                }
+                worker.outstanding.erase(it);
+                if (reply.status == AnalysisStatus::EXPIRED) {
+                    expired = true;
+                    ++done;
+                    continue;
+                }
+                if (reply.status == AnalysisStatus::INVALID) {
+                    throw std::runtime_error("Рабочий отклонил позицию");
+                }
+                int score = -reply.score;
+                // Перебор, прерванный сроком, дал оценку меньшей глубины: ходы корня
+                // нельзя сравнивать, и итерация отбрасывается. Мат точен на любой глубине,
+                // а позиция без ходов (move = 0, глубина 0) — законченная партия.
+                if (reply.depth < childDepth && reply.move != 0 && !isMateScore(score)) {
+                    expired = true;
+                    ++done;
+                    continue;
+                }
+                // Мат, найденный рабочим, на один полуход дальше от корня
+                if (isMateScore(score)) score += score > 0 ? -1 : 1;
+                scores[reply.id] = score;
+                nodes += reply.nodes;
+                ++done;
+            }
+        }
+        return !expired;
+    }
+
+public:
+    /**
+     * @brief Подключиться к рабочим
+     * @param addresses Адреса служб анализа (путь сокета Unix или хост:порт)
+     * @param requestsPerWorker Сколько запросов держать у рабочего одновременно
+     * @throws std::runtime_error если к какому-либо рабочему не удалось подключиться
+     */
+    explicit ClusterSearch(const std::vector<std::string>& addresses, int requestsPerWorker = 2)
+    : window(std::max(1, requestsPerWorker)) {
+        try {
+            for (const std::string& address : addresses) {
+                workers.push_back(Worker{connectTo(address), {}});
+            }
+        } catch (...) {
+            for (Worker& worker : workers) close(worker.fd);
+            throw;
+        }
+        if (workers.empty()) {
+            throw std::invalid_argument("Не задано ни одного рабочего");
+        }
+    }
+
+    ClusterSearch(const ClusterSearch&) = delete;
+    ClusterSearch& operator=(const ClusterSearch&) = delete;
+
+    ~ClusterSearch() {
+        for (Worker& worker : workers) {
+            if (worker.fd >= 0) close(worker.fd);
+        }
+    }
+
+    /**
+     * @brief Найти лучший ход
+     * @param board Позиция классического варианта
+     * @param limits Используются глубина (не меньше 2) и время; лимит узлов не поддерживается
+     * @param onIteration Вызывается после каждой завершённой итерации (может быть пустым)
+     * @return Результат последней завершённой итерации
+     * @throws std::runtime_error если все рабочие отключились
+     */
+    SearchResult run(const Board& board, const SearchLimits& limits,
+                     const std::function<void(const SearchResult&)>& onIteration = nullptr) {
+        SearchResult result;
+        MoveList legal;
+        generateLegalMoves(board, legal);
+        if (legal.size == 0) {
+            result.score = board.inCheck(board.getSideToMove()) ? -MATE_SCORE : 0;
+            return result;
+        }
+        result.bestMove = legal[0];
+
+        std::vector<PackedPosition> children;
+        std::vector<int> order;
+        for (int i = 0; i < legal.size; ++i) {
+            Board child = board;
+            child.makeMove(legal[i]);
+            children.push_back(packPosition(child));
+            order.push_back(i);
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeMs);
+        std::vector<int> scores(children.size());
+        std::uint64_t nodes = 0;
+        for (int depth = 2; depth <= limits.depth && depth < MAX_PLY; ++depth) {
+            if (!iterate(children, order, depth - 1, limits.timeMs ? &deadline : nullptr, scores, nodes)) {
+                break;
+            }
+            std::stable_sort(order.begin(), order.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+            result.bestMove = legal[order.front()];
+            result.score = scores[order.front()];
+            result.depth = depth;
+            result.nodes = nodes;
+            if (onIteration) onIteration(result);
+            if (isMateScore(result.score) && result.score > 0) break;
+        }
+        result.nodes = nodes;
+        return result;
+    }
+
+    /**
+     * @brief Количество подключённых рабочих
+     * @return Число рабочих, не разорвавших соединение
+     */
+    std::size_t workerCount() const {
+        return static_cast<std::size_t>(std::count_if(workers.begin(), workers.end(),
+                                                      [](const Worker& w) { return w.fd >= 0; }));
+    }
+};
+
+}
+
+#endif
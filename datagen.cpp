@@ -0,0 +1,95 @@
+/**
+ * @file datagen.cpp
+ * @brief Генератор обучающих данных самоигрой
+ *
+ * Каждый поток играет партии с фиксированным числом узлов на ход и пишет
+ * записи (упакованная позиция, оценка, исход) в собственный файл-шард
+ * <префикс>.<номер>.bin, поэтому потоки не делят ни файлов, ни блокировок.
+ * С ненулевым размером фильтра повторов позиции, уже записанные любым
+ * потоком, пропускаются (общий фильтр Блума из dedup.h работает без
+ * блокировок); точное отсеивание после генерации делает dedup.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread datagen.cpp -o datagen
+ */
+#include "datagen.h"
+#include "dedup.h"
+#include "fen.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Использование: " << argv[0]
+             << " <префикс> <партий> [узлов на ход] [потоков] [случайных полуходов] [seed]"
+                " [фильтр повторов, МБ]\n";
+        return 1;
+    }
+    string prefix = argv[1];
+    long long games = stoll(argv[2]);
+    Chess::SearchLimits limits;
+    limits.nodes = argc > 3 ? stoull(argv[3]) : 5000;
+    unsigned threads = argc > 4 ? stoul(argv[4]) : 0;
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    int randomPlies = argc > 5 ? stoi(argv[5]) : 8;
+    unsigned long long seed = argc > 6 ? stoull(argv[6]) : 1;
+    size_t filterMegabytes = argc > 7 ? stoull(argv[7]) : 0;
+    unique_ptr<Chess::PositionFilter> filter;
+    if (filterMegabytes > 0) {
+        filter = make_unique<Chess::PositionFilter>(filterMegabytes);
+    }
+
+    const Chess::Board start = Chess::parseFen(Chess::PAWNLESS_START_FEN);
+    atomic<long long> nextGame(0);
+    atomic<unsigned long long> positions(0);
+    auto begin = chrono::steady_clock::now();
+
+    atomic<bool> failed(false);
+    auto worker = [&](unsigned index) {
+        try {
+            Chess::ShardWriter shard(prefix + "." + to_string(index) + ".bin");
+            mt19937_64 rng(seed * 1000003 + index);
+            vector<Chess::TrainingRecord> records;
+            while (!failed && nextGame++ < games) {
+                records.clear();
+                Chess::playSelfPlayGame(start, limits, randomPlies, rng, records);
+                for (const Chess::TrainingRecord& record : records) {
+                    if (filter && !filter->insert(Chess::unpackPosition(record.position).getKey())) {
+                        continue;
+                    }
+                    shard.write(record);
+                    ++positions;
+                }
+            }
+            shard.flush();
+        } catch (const exception& e) {
+            failed = true;
+            cerr << "Ошибка в потоке " << index << ": " << e.what() << '\n';
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back(worker, i);
+    }
+    for (thread& t : pool) {
+        t.join();
+    }
+    if (failed) {
+        return 1;
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "Записано позиций: " << positions << " за " << seconds << " с ("
+         << static_cast<unsigned long long>(positions / max(seconds, 1e-9) * 3600) << " в час)\n";
+    return 0;
+}
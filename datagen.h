@@ -0,0 +1,167 @@
+#ifndef CHESS_DATAGEN_H
+#define CHESS_DATAGEN_H
+
+#include "match.h"
+#include "packed.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Обучающая запись: позиция, оценка перебора и исход партии
+ *
+ * Занимает 36 байт без выравнивания и записывается в файл как есть.
+ */
+struct TrainingRecord {
+    PackedPosition position;   ///< Упакованная позиция
+    std::int16_t score;        ///< Оценка перебора с точки зрения белых
+    std::int8_t result;        ///< Исход партии для белых: 1, 0 или -1
+    std::uint8_t reserved;     ///< Зарезервировано (0)
+};
+
+static_assert(sizeof(TrainingRecord) == 36, "Обучающая запись должна занимать 36 байт");
+
+/**
+ * @brief Буферизованная запись обучающих записей в файл-шард
+ *
+ * Записи накапливаются в памяти и сбрасываются в файл одним вызовом
+ * fwrite, когда буфер заполнен, поэтому системных вызовов на запись мало.
+ * Деструктор сбрасывает остаток, но ошибки записи в нём теряются:
+ * чтобы узнать о них, перед уничтожением вызывается flush().
+ */
+class ShardWriter {
+private:
+    std::FILE* file;
+    std::vector<TrainingRecord> buffer;
+    std::size_t capacity;
+    std::uint64_t written;
+
+public:
+    /**
+     * @brief Открыть шард для записи
+     * @param path Путь к файлу
+     * @param bufferRecords Размер буфера в записях
+     * @throws std::runtime_error если файл не удалось создать
+     */
+    explicit ShardWriter(const std::string& path, std::size_t bufferRecords = 1 << 16)
+    : file(std::fopen(path.c_str(), "wb")), capacity(bufferRecords), written(0) {
+        if (!file) {
+            throw std::runtime_error("Не удалось создать " + path);
+        }
+        buffer.reserve(capacity);
+    }
+
+    ShardWriter(const ShardWriter&) = delete;
+    ShardWriter& operator=(const ShardWriter&) = delete;
+
+    ~ShardWriter() {
+        try {
+            flush();
+        } catch (const std::runtime_error&) {
+        }
+        std::fclose(file);
+    }
+
+    /**
+     * @brief Добавить запись
+     * @param record Обучающая запись
+     */
+    void write(const TrainingRecord& record) {
+        buffer.push_back(record);
+        if (buffer.size() >= capacity) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Сбросить буфер в файл
+     * @throws std::runtime_error при ошибке записи
+     */
+    void flush() {
+        if (!buffer.empty() &&
+            std::fwrite(buffer.data(), sizeof(TrainingRecord), buffer.size(), file) != buffer.size()) {
+            buffer.clear();
+            throw std::runtime_error("Ошибка записи обучающих данных");
+        }
+        if (std::fflush(file) != 0) {
+            buffer.clear();
+            throw std::runtime_error("Ошибка записи обучающих данных");
+        }
+        written += buffer.size();
+        buffer.clear();
+    }
+
+    /**
+     * @brief Количество записей, переданных в шард
+     * @return Число записей (включая ещё не сброшенные)
+     */
+    std::uint64_t getRecordCount() const { return written + buffer.size(); }
+};
+
+/**
+ * @brief Сыграть партию самоигры и собрать обучающие записи
+ * @param start Начальная позиция
+ * @param limits Ограничения перебора на ход (обычно фиксированное число узлов)
+ * @param randomPlies Число первых случайных полуходов для разнообразия дебютов
+ * @param rng Генератор случайных чисел потока
+ * @param[out] records Записи партии (добавляются в конец)
+ * @return Исход партии
+ *
+ * Позиции под шахом и с матовой оценкой не записываются: их оценка
+ * не отражает статическую силу позиции.
+ */
+inline GameResult playSelfPlayGame(const Board& start, const SearchLimits& limits, int randomPlies,
+                                   std::mt19937_64& rng, std::vector<TrainingRecord>& records) {
+    Board board = start;
+    std::vector<std::uint64_t> history;
+    std::size_t first = records.size();
+    std::string reason;
+    GameResult result = GameResult::DRAW;
+    for (int ply = 0; ply < 400; ++ply) {
+        MoveList legal;
+        generateLegalMoves(board, legal);
+        if (legal.size == 0) {
+            if (board.inCheck(board.getSideToMove())) {
+                result = board.getSideToMove() == Color::WHITE ? GameResult::BLACK_WIN : GameResult::WHITE_WIN;
+            }
+            break;
+        }
+        if (isRuleDraw(board, history, reason)) {
+            break;
+        }
+        Move move;
+        if (ply < randomPlies) {
+            move = legal[static_cast<int>(rng() % static_cast<std::uint64_t>(legal.size))];
+        } else {
+            Search search(limits);
+            search.setHistory(history);
+            SearchResult found = search.run(board);
+            move = found.bestMove;
+            if (!board.inCheck(board.getSideToMove()) && !isMateScore(found.score)) {
+                int white = board.getSideToMove() == Color::WHITE ? found.score : -found.score;
+                records.push_back({packPosition(board), static_cast<std::int16_t>(white), 0, 0});
+            }
+        }
+        history.push_back(board.getKey());
+        board.makeMove(move);
+    }
+    std::int8_t whiteResult = result == GameResult::WHITE_WIN ? 1 : result == GameResult::BLACK_WIN ? -1 : 0;
+    for (std::size_t i = first; i < records.size(); ++i) {
+        records[i].result = whiteResult;
+    }
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file dedup.cpp
+ * @brief Отсеивание повторных позиций в обучающих данных
+ *
+ * Читает файлы-шарды генератора datagen и пишет в один файл записи,
+ * позиции которых ещё не встречались. Позиции сравниваются по ключу
+ * Зобриста (symmetry=1 — по каноническому ключу, так что симметричные
+ * позиции тоже считаются повторами) с помощью фильтра Блума, поэтому
+ * память не зависит от объёма данных. Фильтр изредка отбрасывает новую
+ * позицию; exact=1 добавляет второй проход по тем же файлам, после
+ * которого остаётся ровно одна запись каждой позиции.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread dedup.cpp -o dedup
+ */
+#include "datagen.h"
+#include "dedup.h"
+#include "symmetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Прочитать шарды в несколько потоков
+ * @param visit Вызывается для каждого блока записей; блоки одного файла идут по порядку
+ */
+template <class Visitor>
+void scanShards(const vector<string>& paths, unsigned threads, Visitor visit) {
+    atomic<size_t> next(0);
+    atomic<bool> failed(false);
+    string error;
+    mutex errorMutex;
+    auto worker = [&] {
+        vector<Chess::TrainingRecord> buffer(1 << 16);
+        try {
+            for (size_t i; !failed && (i = next++) < paths.size(); ) {
+                FILE* file = fopen(paths[i].c_str(), "rb");
+                if (!file) {
+                    throw runtime_error("Не удалось открыть " + paths[i]);
+                }
+                size_t count;
+                while ((count = fread(buffer.data(), sizeof(Chess::TrainingRecord), buffer.size(), file)) > 0) {
+                    visit(buffer.data(), count);
+                }
+                fclose(file);
+            }
+        } catch (const exception& e) {
+            lock_guard<mutex> lock(errorMutex);
+            failed = true;
+            error = e.what();
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (thread& t : pool) {
+        t.join();
+    }
+    if (failed) {
+        throw runtime_error(error);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Использование: " << argv[0]
+             << " <выход.bin> <шард>... [mb=N] [exact=1] [symmetry=1] [threads=N]\n";
+        return 1;
+    }
+    string output = argv[1];
+    vector<string> shards;
+    size_t megabytes = 1024;
+    bool exact = false;
+    bool symmetry = false;
+    unsigned threads = 0;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == string::npos) {
+            shards.push_back(arg);
+            continue;
+        }
+        string key = arg.substr(0, eq), value = arg.substr(eq + 1);
+        if (key == "mb") megabytes = stoull(value);
+        else if (key == "exact") exact = value != "0";
+        else if (key == "symmetry") symmetry = value != "0";
+        else if (key == "threads") threads = stoul(value);
+        else {
+            cerr << "Неизвестный параметр: " << key << '\n';
+            return 1;
+        }
+    }
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    auto keyOf = [symmetry](const Chess::TrainingRecord& record) {
+        Chess::Board board = Chess::unpackPosition(record.position);
+        return symmetry ? Chess::canonicalKey(board) : board.getKey();
+    };
+
+    try {
+        auto begin = chrono::steady_clock::now();
+        Chess::ShardWriter writer(output);
+        mutex writerMutex;
+        atomic<unsigned long long> total(0);
+        // Оставленные записи блока пишутся под мьютексом одним куском
+        auto writeKept = [&](const vector<Chess::TrainingRecord>& kept) {
+            lock_guard<mutex> lock(writerMutex);
+            for (const Chess::TrainingRecord& record : kept) {
+                writer.write(record);
+            }
+        };
+
+        if (exact) {
+            Chess::ExactDeduplicator dedup(megabytes);
+            scanShards(shards, threads, [&](const Chess::TrainingRecord* records, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    dedup.observe(keyOf(records[i]));
+                }
+                total += count;
+            });
+            dedup.finishFirstPass();
+            cout << "Первый проход: " << total << " позиций, точно хранится ключей: "
+                 << dedup.candidateCount() << '\n';
+            scanShards(shards, threads, [&](const Chess::TrainingRecord* records, size_t count) {
+                vector<Chess::TrainingRecord> kept;
+                for (size_t i = 0; i < count; ++i) {
+                    if (dedup.keep(keyOf(records[i]))) {
+                        kept.push_back(records[i]);
+                    }
+                }
+                writeKept(kept);
+            });
+        } else {
+            Chess::PositionFilter filter(megabytes);
+            scanShards(shards, threads, [&](const Chess::TrainingRecord* records, size_t count) {
+                vector<Chess::TrainingRecord> kept;
+                for (size_t i = 0; i < count; ++i) {
+                    if (filter.insert(keyOf(records[i]))) {
+                        kept.push_back(records[i]);
+                    }
+                }
+                total += count;
+                writeKept(kept);
+            });
+            cout << "Фильтр " << (filter.bytes() >> 20) << " МБ, оценка доли ложных повторов: "
+                 << filter.falsePositiveRate() << '\n';
+        }
+        writer.flush();
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << "Прочитано позиций: " << total << ", записано: " << writer.getRecordCount()
+             << " за " << seconds << " с\n";
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
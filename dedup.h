@@ -0,0 +1,317 @@
+#ifndef CHESS_DEDUP_H
+#define CHESS_DEDUP_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Фильтр Блума для отсеивания повторных позиций по ключу Зобриста
+ *
+ * Точное множество ключей для миллиардов позиций не помещается в память,
+ * фильтру же 16 бит на позицию дают около 0,4% ложных повторов, 24 бита —
+ * около 0,1%. Все BITS_PER_KEY битов ключа
+ * лежат в одном 64-битном слове (блочный фильтр), поэтому вставка — это
+ * одна атомарная операция fetch_or: она без блокировок и ровно одному из
+ * потоков, одновременно вставляющих одну позицию, сообщает, что позиция
+ * новая. Слова разбиты на SHARD_COUNT шардов по старшим битам ключа:
+ * каждый шард — отдельный массив со своим счётчиком, так что гигабайтные
+ * фильтры выделяются частями, а потоки не спорят за один счётчик.
+ *
+ * Ложных пропусков нет: повтор всегда распознаётся. Ложные срабатывания
+ * возможны — новая позиция изредка считается повтором; их долю оценивает
+ * falsePositiveRate(), а убрать их совсем позволяет ExactDeduplicator.
+ */
+class PositionFilter {
+public:
+    static constexpr int SHARD_BITS = 6;                       ///< Старших битов ключа на номер шарда
+    static constexpr std::size_t SHARD_COUNT = std::size_t(1) << SHARD_BITS; ///< Количество шардов
+    static constexpr int BITS_PER_KEY = 6;                     ///< Битов слова на один ключ
+
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+        std::atomic<std::uint64_t> inserted{0};
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    std::size_t wordMask;
+
+    /**
+     * @brief Биты ключа внутри слова
+     *
+     * Номер шарда и слова берутся из битов ключа, а номера битов —
+     * из перемешанного ключа, чтобы не зависеть от них.
+     */
+    static std::uint64_t pattern(std::uint64_t key) {
+        std::uint64_t h = (key ^ (key >> 29)) * 0xBF58476D1CE4E5B9ULL;
+        std::uint64_t bits = 0;
+        for (int i = 0; i < BITS_PER_KEY; ++i) {
+            bits |= std::uint64_t(1) << ((h >> (58 - 6 * i)) & 63);
+        }
+        return bits;
+    }
+
+    std::atomic<std::uint64_t>& wordOf(std::uint64_t key) const {
+        return shards[key >> (64 - SHARD_BITS)].words[static_cast<std::size_t>(key) & wordMask];
+    }
+
+public:
+    /**
+     * @brief Конструктор фильтра
+     * @param megabytes Размер в мегабайтах (округляется вниз до степени двойки, не меньше 1 МБ)
+     */
+    explicit PositionFilter(std::size_t megabytes = 256) : shards(new Shard[SHARD_COUNT]) {
+        std::size_t words = 1;
+        while (words * 2 * SHARD_COUNT * sizeof(std::uint64_t) <= (std::max<std::size_t>(megabytes, 1) << 20)) {
+            words *= 2;
+        }
+        wordMask = words - 1;
+        for (std::size_t s = 0; s < SHARD_COUNT; ++s) {
+            shards[s].words.reset(new std::atomic<std::uint64_t>[words]);
+        }
+        clear();
+    }
+
+    PositionFilter(const PositionFilter&) = delete;
+    PositionFilter& operator=(const PositionFilter&) = delete;
+
+    /**
+     * @brief Размер фильтра, при котором доля ложных срабатываний не превысит заданную
+     * @param positions Ожидаемое число различных позиций
+     * @param rate Допустимая доля ложных срабатываний
+     * @return Размер в мегабайтах
+     */
+    static std::size_t megabytesFor(std::uint64_t positions, double rate) {
+        if (rate <= 0 || rate >= 1) {
+            throw std::invalid_argument("Доля ложных срабатываний должна быть между 0 и 1");
+        }
+        for (std::size_t megabytes = 1; ; megabytes *= 2) {
+            double words = double(megabytes << 20) / sizeof(std::uint64_t);
+            if (estimateRate(double(positions) / words) <= rate || megabytes >= (std::size_t(1) << 20)) {
+                return megabytes;
+            }
+        }
+    }
+
+    /**
+     * @brief Оценка доли ложных срабатываний
+     * @param keysPerWord Среднее число вставленных ключей на слово
+     * @return Вероятность, что новый ключ найдёт все свои биты установленными
+     *
+     * Число ключей в слове распределено по Пуассону со средним keysPerWord;
+     * переполненные слова дают почти все ложные срабатывания, поэтому
+     * вероятность усредняется по распределению, а не берётся для среднего.
+     */
+    static double estimateRate(double keysPerWord) {
+        if (keysPerWord > 500) return 1.0;   // exp(-keysPerWord) теряет точность, а слова заполнены
+        double probability = std::exp(-keysPerWord);   // P(n) для n = 0
+        double rate = 0;
+        double covered = 0;
+        for (int n = 0; covered < 1 - 1e-12 && n < 100000; ++n) {
+            // Доля установленных битов слова после n ключей: 1 - (63/64)^(BITS_PER_KEY * n)
+            double filled = 1.0 - std::pow(63.0 / 64.0, BITS_PER_KEY * n);
+            rate += probability * std::pow(filled, BITS_PER_KEY);
+            covered += probability;
+            probability *= keysPerWord / (n + 1);
+        }
+        return rate + (1 - covered);
+    }
+
+    /**
+     * @brief Вставить ключ
+     * @param key Ключ позиции
+     * @return true если ключа в фильтре точно не было
+     */
+    bool insert(std::uint64_t key) {
+        std::uint64_t bits = pattern(key);
+        if ((wordOf(key).fetch_or(bits, std::memory_order_relaxed) & bits) == bits) {
+            return false;
+        }
+        shards[key >> (64 - SHARD_BITS)].inserted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Проверить ключ без вставки
+     * @param key Ключ позиции
+     * @return false если ключа точно нет; true если он, вероятно, есть
+     */
+    bool contains(std::uint64_t key) const {
+        std::uint64_t bits = pattern(key);
+        return (wordOf(key).load(std::memory_order_relaxed) & bits) == bits;
+    }
+
+    /**
+     * @brief Очистить фильтр (не вызывать одновременно с другими методами)
+     */
+    void clear() {
+        for (std::size_t s = 0; s < SHARD_COUNT; ++s) {
+            for (std::size_t w = 0; w <= wordMask; ++w) {
+                shards[s].words[w].store(0, std::memory_order_relaxed);
+            }
+            shards[s].inserted.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Количество ключей, признанных новыми
+     * @return Число успешных insert()
+     */
+    std::uint64_t insertedCount() const {
+        std::uint64_t total = 0;
+        for (std::size_t s = 0; s < SHARD_COUNT; ++s) {
+            total += shards[s].inserted.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Размер фильтра
+     * @return Размер в байтах
+     */
+    std::size_t bytes() const { return SHARD_COUNT * (wordMask + 1) * sizeof(std::uint64_t); }
+
+    /**
+     * @brief Текущая оценка доли ложных срабатываний
+     * @return Вероятность, что следующий новый ключ будет принят за повтор
+     */
+    double falsePositiveRate() const {
+        return estimateRate(double(insertedCount()) / double(SHARD_COUNT * (wordMask + 1)));
+    }
+};
+
+/**
+ * @brief Точное отсеивание повторов в два прохода по данным
+ *
+ * Первый проход (observe) пропускает все ключи через фильтр Блума и
+ * запоминает те, что фильтр счёл повторами: настоящие повторы и редкие
+ * ложные срабатывания. Таких ключей намного меньше, чем всех позиций,
+ * и они хранятся точно; повторные встречи одного ключа сжимаются по ходу
+ * прохода, так что память растёт с числом различных ключей, а не встреч.
+ * Второй проход (keep) оставляет ключ, если его нет
+ * среди запомненных, а запомненный — только при первой встрече.
+ *
+ * Оба прохода можно вести из нескольких потоков; данные второго прохода
+ * должны совпадать с данными первого (например, те же файлы).
+ */
+class ExactDeduplicator {
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<std::uint64_t> candidates;
+        std::size_t compacted = 0;     // размер после последнего сжатия
+        std::unique_ptr<std::atomic<std::uint8_t>[]> taken;
+    };
+
+    static constexpr std::size_t MIN_COMPACT = 1024;   ///< Ключей шарда, до которых сжатие не нужно
+
+    PositionFilter filter;
+    std::unique_ptr<Shard[]> shards;
+    bool sealed;
+
+    Shard& shardOf(std::uint64_t key) { return shards[key >> (64 - PositionFilter::SHARD_BITS)]; }
+
+    /**
+     * @brief Отсортировать ключи шарда и убрать повторы
+     */
+    static void compact(std::vector<std::uint64_t>& keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+public:
+    /**
+     * @brief Конструктор
+     * @param megabytes Размер фильтра первого прохода в мегабайтах
+     */
+    explicit ExactDeduplicator(std::size_t megabytes = 256)
+    : filter(megabytes), shards(new Shard[PositionFilter::SHARD_COUNT]), sealed(false) {}
+
+    /**
+     * @brief Первый проход: учесть ключ
+     * @param key Ключ позиции
+     * @throws std::logic_error если первый проход уже завершён
+     */
+    void observe(std::uint64_t key) {
+        if (sealed) {
+            throw std::logic_error("Первый проход уже завершён");
+        }
+        if (!filter.insert(key)) {
+            Shard& shard = shardOf(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.candidates.push_back(key);
+            // Сжатие при удвоении: учётная стоимость O(log n) на ключ
+            if (shard.candidates.size() >= 2 * std::max(shard.compacted, MIN_COMPACT)) {
+                compact(shard.candidates);
+                shard.compacted = shard.candidates.size();
+            }
+        }
+    }
+
+    /**
+     * @brief Завершить первый проход
+     *
+     * Вызывается один раз, когда все потоки первого прохода закончили работу.
+     * Память фильтра после этого не нужна, но освобождается только в деструкторе.
+     */
+    void finishFirstPass() {
+        for (std::size_t s = 0; s < PositionFilter::SHARD_COUNT; ++s) {
+            std::vector<std::uint64_t>& keys = shards[s].candidates;
+            compact(keys);
+            keys.shrink_to_fit();
+            shards[s].taken.reset(new std::atomic<std::uint8_t>[keys.size()]);
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                shards[s].taken[i].store(0, std::memory_order_relaxed);
+            }
+        }
+        sealed = true;
+    }
+
+    /**
+     * @brief Второй проход: оставить ли позицию
+     * @param key Ключ позиции
+     * @return true ровно для одной встречи каждого ключа
+     * @throws std::logic_error если первый проход не завершён
+     */
+    bool keep(std::uint64_t key) {
+        if (!sealed) {
+            throw std::logic_error("Первый проход не завершён");
+        }
+        Shard& shard = shardOf(key);
+        auto found = std::lower_bound(shard.candidates.begin(), shard.candidates.end(), key);
+        if (found == shard.candidates.end() || *found != key) {
+            return true;
+        }
+        return shard.taken[found - shard.candidates.begin()].exchange(1, std::memory_order_relaxed) == 0;
+    }
+
+    /**
+     * @brief Количество ключей, которые хранятся точно
+     * @return Число ключей, признанных фильтром повторами
+     */
+    std::size_t candidateCount() {
+        std::size_t total = 0;
+        for (std::size_t s = 0; s < PositionFilter::SHARD_COUNT; ++s) {
+            std::lock_guard<std::mutex> lock(shards[s].mutex);
+            total += shards[s].candidates.size();
+        }
+        return total;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef CHESS_DISTANCE_H
+#define CHESS_DISTANCE_H
+
+#include "board.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Таблица расстояний: минимальное число ходов фигуры между клетками
+ */
+using DistanceTable = std::array<std::array<std::uint8_t, SQUARE_COUNT>, SQUARE_COUNT>;
+
+constexpr std::uint8_t UNREACHABLE = 0xFF; ///< Клетка недостижима для фигуры
+
+/**
+ * @brief Правило одного хода фигуры на пустой доске
+ *
+ * Специализируется для каждого класса фигуры; targets(sq) возвращает
+ * клетки, достижимые за один ход с клетки sq.
+ */
+template <class Piece>
+struct StepRule;
+
+/**
+ * @brief Ходы коня по шаблонам JumpingPiece::movePatterns
+ */
+template <>
+struct StepRule<Knight> {
+    static constexpr Bitboard targets(int sq) {
+        Bitboard result = 0;
+        for (int i = 0; i < JumpingPiece::getPatternTableSize(); ++i) {
+            int x = squareX(sq) + JumpingPiece::getPatternDeltaX(i);
+            int y = squareY(sq) + JumpingPiece::getPatternDeltaY(i);
+            if (isOnBoard(x, y)) {
+                result |= squareBit(makeSquare(x, y));
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Ходы короля по правилу King::isStep
+ */
+template <>
+struct StepRule<King> {
+    static constexpr Bitboard targets(int sq) {
+        Bitboard result = 0;
+        for (int to = 0; to < SQUARE_COUNT; ++to) {
+            if (King::isStep(squareX(to) - squareX(sq), squareY(to) - squareY(sq))) {
+                result |= squareBit(to);
+            }
+        }
+        return result;
+    }
+};
+
+template <>
+struct StepRule<Rook> {
+    static constexpr Bitboard targets(int sq) { return rookAttacks(sq, 0); }
+};
+
+template <>
+struct StepRule<Bishop> {
+    static constexpr Bitboard targets(int sq) { return bishopAttacks(sq, 0); }
+};
+
+template <>
+struct StepRule<Queen> {
+    static constexpr Bitboard targets(int sq) { return queenAttacks(sq, 0); }
+};
+
+namespace detail {
+
+/**
+ * @brief Построить таблицу расстояний обходом в ширину от каждой клетки
+ */
+template <class Piece>
+constexpr DistanceTable makeDistanceTable() {
+    std::array<Bitboard, SQUARE_COUNT> steps{};
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        steps[sq] = StepRule<Piece>::targets(sq);
+    }
+    DistanceTable table{};
+    for (int from = 0; from < SQUARE_COUNT; ++from) {
+        for (int to = 0; to < SQUARE_COUNT; ++to) {
+            table[from][to] = UNREACHABLE;
+        }
+        table[from][from] = 0;
+        Bitboard visited = squareBit(from);
+        Bitboard frontier = visited;
+        for (std::uint8_t d = 1; frontier; ++d) {
+            Bitboard next = 0;
+            while (frontier) {
+                next |= steps[popLowestSquare(frontier)];
+            }
+            next &= ~visited;
+            visited |= next;
+            frontier = next;
+            for (Bitboard b = next; b; ) {
+                table[from][popLowestSquare(b)] = d;
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace detail
+
+/**
+ * @brief Расстояние в ходах фигуры: distance<Knight>[from][to]
+ *
+ * Вычисляется на этапе компиляции, поэтому обращение стоит одного чтения из памяти.
+ */
+template <class Piece>
+inline constexpr DistanceTable distance = detail::makeDistanceTable<Piece>();
+
+namespace detail {
+
+constexpr bool knightAttacksMatchPatterns() {
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        if (StepRule<Knight>::targets(sq) != KNIGHT_ATTACKS[sq]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+static_assert(detail::knightAttacksMatchPatterns(),
+              "Таблица атак коня должна совпадать с шаблонами JumpingPiece");
+
+/**
+ * @brief Оценка близости фигур к королю соперника (king tropism)
+ * @param board Позиция
+ * @param col Цвет атакующей стороны
+ * @return Сумма бонусов: чем меньше ходов фигуре до короля, тем больше бонус
+ */
+inline int kingTropism(const Board& board, Color col) {
+    Bitboard enemyKing = board.piecesOf(opposite(col), PieceKind::KING);
+    if (!enemyKing) {
+        return 0;
+    }
+    int kingSquare = lowestSquare(enemyKing);
+    int score = 0;
+    Bitboard knights = board.piecesOf(col, PieceKind::KNIGHT);
+    while (knights) {
+        score += 6 - std::min(6, int(distance<Knight>[popLowestSquare(knights)][kingSquare]));
+    }
+    Bitboard sliders = board.piecesOf(col, PieceKind::QUEEN) | board.piecesOf(col, PieceKind::ROOK);
+    while (sliders) {
+        score += 7 - distance<King>[popLowestSquare(sliders)][kingSquare];
+    }
+    return score;
+}
+
+/**
+ * @brief Решатель задачи об обходе доски конём
+ *
+ * Использует правило Варнсдорфа (сначала клетки с наименьшим числом
+ * продолжений) с возвратом при тупике. Посещённые клетки хранятся в битовой доске.
+ */
+class KnightTour {
+private:
+    std::array<int, SQUARE_COUNT> path;
+    std::uint64_t nodes;
+    std::uint64_t nodeLimit;
+
+    bool extend(int sq, Bitboard visited, int depth) {
+        path[depth] = sq;
+        if (depth == SQUARE_COUNT - 1) {
+            return true;
+        }
+        if (++nodes > nodeLimit) {
+            return false;
+        }
+        // Кандидаты упорядочиваются по числу свободных продолжений
+        int candidates[8];
+        int degrees[8];
+        int count = 0;
+        Bitboard moves = KNIGHT_ATTACKS[sq] & ~visited;
+        while (moves) {
+            int to = popLowestSquare(moves);
+            int degree = popCount(KNIGHT_ATTACKS[to] & ~visited & ~squareBit(to));
+            int i = count++;
+            for (; i > 0 && degrees[i - 1] > degree; --i) {
+                candidates[i] = candidates[i - 1];
+                degrees[i] = degrees[i - 1];
+            }
+            candidates[i] = to;
+            degrees[i] = degree;
+        }
+        for (int i = 0; i < count; ++i) {
+            // Клетка без продолжений допустима только как последняя
+            if (degrees[i] == 0 && depth + 2 < SQUARE_COUNT) {
+                continue;
+            }
+            if (extend(candidates[i], visited | squareBit(candidates[i]), depth + 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    /**
+     * @brief Конструктор решателя
+     * @param limit Максимальное число узлов перебора
+     */
+    explicit KnightTour(std::uint64_t limit = 10000000) : path{}, nodes(0), nodeLimit(limit) {}
+
+    /**
+     * @brief Найти обход доски с заданной клетки
+     * @param start Начальная клетка
+     * @return true если обход найден в пределах лимита узлов
+     */
+    bool solve(int start) {
+        nodes = 0;
+        return extend(start, squareBit(start), 0);
+    }
+
+    /**
+     * @brief Получить найденный обход
+     * @return Последовательность из 64 клеток
+     */
+    const std::array<int, SQUARE_COUNT>& getPath() const { return path; }
+
+    /**
+     * @brief Количество узлов последнего перебора
+     * @return Число рассмотренных узлов
+     */
+    std::uint64_t getNodeCount() const { return nodes; }
+};
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file epd.cpp
+ * @brief Прогон тестового набора позиций EPD
+ *
+ * Для каждой позиции с операциями bm/am выполняется перебор с ограничением
+ * по времени ("500") или по глубине ("d6"). Перебор однопоточный, поэтому
+ * параллельно обрабатываются разные позиции. В конце печатается число решённых
+ * позиций и суммарное время до решения.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread epd.cpp -o epd
+ */
+#include "epd.h"
+#include "thread_pool.h"
+
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0] << " <набор.epd> [мс на позицию | dГЛУБИНА] [потоков]\n";
+        return 1;
+    }
+    ifstream input(argv[1]);
+    if (!input) {
+        cerr << "Не удалось открыть " << argv[1] << '\n';
+        return 1;
+    }
+
+    Chess::SearchLimits limits;
+    string limit = argc > 2 ? argv[2] : "1000";
+    if (!limit.empty() && limit[0] == 'd') {
+        limits.depth = stoi(limit.substr(1));
+    } else {
+        limits.timeMs = stoi(limit);
+    }
+    Chess::ThreadPool pool(argc > 3 ? stoul(argv[3]) : 0);
+
+    const size_t window = 2 * pool.size();
+    deque<future<Chess::EpdResult>> pending;
+    size_t total = 0, solved = 0, errors = 0;
+    double solveTime = 0;
+
+    auto reportOldest = [&]() {
+        Chess::EpdResult result = pending.front().get();
+        pending.pop_front();
+        ++total;
+        cout << setw(20) << left << result.id << ' ';
+        if (!result.error.empty()) {
+            ++errors;
+            cout << "ОШИБКА: " << result.error << '\n';
+            return;
+        }
+        if (result.solved) {
+            ++solved;
+            solveTime += result.solveTimeMs;
+        }
+        cout << (result.solved ? "решено   " : "не решено") << ' ' << setw(8) << result.move
+             << " глубина " << result.depth << ", узлов " << result.nodes;
+        if (result.solved) {
+            cout << ", время до решения " << fixed << setprecision(0) << result.solveTimeMs << " мс";
+        }
+        cout << '\n';
+    };
+
+    string line;
+    while (getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        pending.push_back(pool.submit([line, limits]() {
+            try {
+                return Chess::runEpdPosition(Chess::parseEpdLine(line), limits);
+            } catch (const exception& e) {
+                Chess::EpdResult result;
+                result.error = e.what();
+                return result;
+            }
+        }));
+        if (pending.size() >= window) {
+            reportOldest();
+        }
+    }
+    while (!pending.empty()) {
+        reportOldest();
+    }
+
+    cout << "\nРешено " << solved << " из " << total;
+    if (errors > 0) {
+        cout << " (ошибок разбора: " << errors << ")";
+    }
+    cout << ", суммарное время до решения " << fixed << setprecision(0) << solveTime << " мс\n";
+    return 0;
+}
@@ -0,0 +1,145 @@
+#ifndef CHESS_EPD_H
+#define CHESS_EPD_H
+
+#include "fen.h"
+#include "search.h"
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Позиция тестового набора в формате EPD
+ */
+struct EpdPosition {
+    std::string id;                     ///< Значение операции id
+    std::string fen;                    ///< Позиция (счётчики ходов дополнены "0 1")
+    std::vector<std::string> bestMoves; ///< Операция bm: верные ходы в SAN
+    std::vector<std::string> avoidMoves;///< Операция am: ходы, которых следует избегать
+};
+
+/**
+ * @brief Разобрать строку EPD
+ * @param line Строка вида "<расстановка> <ход> <рокировка> <ep> bm Ra8; id \"x\";"
+ * @return Позиция с операциями bm, am и id (прочие операции игнорируются)
+ * @throws std::invalid_argument если меньше четырёх полей позиции или нет bm и am
+ */
+inline EpdPosition parseEpdLine(const std::string& line) {
+    std::istringstream in(line);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        if (!(in >> field)) {
+            throw std::invalid_argument("Строка EPD должна начинаться с четырёх полей позиции");
+        }
+    }
+    EpdPosition position;
+    position.fen = fields[0] + ' ' + fields[1] + ' ' + fields[2] + ' ' + fields[3] + " 0 1";
+
+    std::string rest;
+    std::getline(in, rest);
+    std::istringstream operations(rest);
+    for (std::string operation; std::getline(operations, operation, ';'); ) {
+        std::istringstream tokens(operation);
+        std::string opcode;
+        if (!(tokens >> opcode)) {
+            continue;
+        }
+        std::vector<std::string> operands;
+        for (std::string operand; tokens >> operand; ) {
+            operands.push_back(operand);
+        }
+        if (opcode == "bm") {
+            position.bestMoves = operands;
+        } else if (opcode == "am") {
+            position.avoidMoves = operands;
+        } else if (opcode == "id") {
+            std::string id;
+            for (const std::string& part : operands) {
+                id += (id.empty() ? "" : " ") + part;
+            }
+            if (id.size() >= 2 && id.front() == '"' && id.back() == '"') {
+                id = id.substr(1, id.size() - 2);
+            }
+            position.id = id;
+        }
+    }
+    if (position.bestMoves.empty() && position.avoidMoves.empty()) {
+        throw std::invalid_argument("Строка EPD не содержит операций bm или am");
+    }
+    return position;
+}
+
+/**
+ * @brief Результат перебора позиции тестового набора
+ */
+struct EpdResult {
+    std::string id;
+    bool solved = false;          ///< Итоговый ход завершённой итерации удовлетворяет bm/am
+    std::string move;             ///< Найденный ход в SAN
+    double solveTimeMs = -1;      ///< Время, с которого ход оставался верным (-1 — не решено)
+    int depth = 0;                ///< Глубина последней завершённой итерации
+    std::uint64_t nodes = 0;
+    std::string error;            ///< Ошибка разбора позиции
+};
+
+/**
+ * @brief Найти ход в позиции тестового набора и проверить его
+ * @param position Позиция с операциями bm/am
+ * @param limits Ограничения перебора (время или глубина)
+ * @return Результат; время решения фиксируется по итерациям углубления
+ */
+inline EpdResult runEpdPosition(const EpdPosition& position, const SearchLimits& limits) {
+    EpdResult result;
+    result.id = position.id;
+    try {
+        Board board = parseFen(position.fen);
+        std::vector<Move> best, avoid;
+        for (const std::string& san : position.bestMoves) best.push_back(parseSan(board, san));
+        for (const std::string& san : position.avoidMoves) avoid.push_back(parseSan(board, san));
+        auto isCorrect = [&best, &avoid](Move move) {
+            for (Move m : avoid) if (m == move) return false;
+            if (best.empty()) return true;
+            for (Move m : best) if (m == move) return true;
+            return false;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        Search search(limits);
+        search.setIterationCallback([&](const SearchResult& iteration) {
+            if (!isCorrect(iteration.bestMove)) {
+                result.solveTimeMs = -1;
+            } else if (result.solveTimeMs < 0) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                result.solveTimeMs = std::chrono::duration<double, std::milli>(elapsed).count();
+            }
+        });
+        SearchResult found = search.run(board);
+        result.nodes = found.nodes;
+        result.depth = found.depth;
+        // Если лимит остановил перебор до конца первой итерации, ход — первый
+        // законный, а не найденный: позиция не решена
+        result.solved = found.depth > 0 && !found.bestMove.isNone() && isCorrect(found.bestMove);
+        if (!result.solved) {
+            result.solveTimeMs = -1;
+        }
+        if (!found.bestMove.isNone()) {
+            result.move = moveToSan(board, found.bestMove);
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+}
+
+#endif
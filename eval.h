@@ -0,0 +1,92 @@
+#ifndef CHESS_EVAL_H
+#define CHESS_EVAL_H
+
+#include "distance.h"
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/// Материальная стоимость фигур в сотых долях пешки (король не учитывается)
+constexpr int PIECE_VALUES[PIECE_KIND_COUNT] = {320, 330, 500, 900, 0};
+
+/**
+ * @brief Проверить, что ни одна сторона не может поставить мат
+ * @param board Позиция
+ * @return true если на доске только короли и не более одной лёгкой фигуры у каждой стороны
+ */
+inline bool isInsufficientMaterial(const Board& board) {
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        if (board.piecesOf(col, PieceKind::ROOK) || board.piecesOf(col, PieceKind::QUEEN)) {
+            return false;
+        }
+        int minors = popCount(board.piecesOf(col, PieceKind::KNIGHT) | board.piecesOf(col, PieceKind::BISHOP));
+        if (minors > 1) {
+            return false;
+        }
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            if (board.getPocketCount(col, static_cast<PieceKind>(k)) > 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Параметры оценочной функции
+ *
+ * Позволяет сравнивать и настраивать разные конфигурации оценки
+ * без изменения кода перебора.
+ */
+struct EvalParams {
+    int pieceValues[PIECE_KIND_COUNT] = {PIECE_VALUES[0], PIECE_VALUES[1], PIECE_VALUES[2],
+                                         PIECE_VALUES[3], PIECE_VALUES[4]}; ///< Стоимость фигур
+    int tropismWeight = 2; ///< Вес близости фигур к королю соперника
+    /// Бонусы за положение фигур с точки зрения белых; для чёрных доска отражается по вертикали
+    int pieceSquare[PIECE_KIND_COUNT][SQUARE_COUNT] = {};
+};
+
+/**
+ * @brief Клетка с точки зрения стороны
+ * @param col Цвет
+ * @param sq Номер клетки
+ * @return sq для белых; для чёрных — клетка, отражённая сверху вниз
+ */
+constexpr int relativeSquare(Color col, int sq) { return col == Color::WHITE ? sq : sq ^ 56; }
+
+/// Параметры оценки по умолчанию
+inline const EvalParams DEFAULT_EVAL_PARAMS{};
+
+/**
+ * @brief Статическая оценка позиции
+ * @param board Позиция
+ * @param params Параметры оценки
+ * @return Оценка с точки зрения стороны, делающей ход
+ *
+ * Учитывает материал на доске и в карманах, положение фигур
+ * и близость фигур к королю соперника.
+ */
+inline int evaluate(const Board& board, const EvalParams& params = DEFAULT_EVAL_PARAMS) {
+    int score[COLOR_COUNT] = {0, 0};
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        int c = colorIndex(col);
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            PieceKind kind = static_cast<PieceKind>(k);
+            score[c] += params.pieceValues[k]
+                        * (popCount(board.piecesOf(col, kind)) + board.getPocketCount(col, kind));
+            for (Bitboard b = board.piecesOf(col, kind); b; ) {
+                score[c] += params.pieceSquare[k][relativeSquare(col, popLowestSquare(b))];
+            }
+        }
+        score[c] += params.tropismWeight * kingTropism(board, col);
+    }
+    int white = score[0] - score[1];
+    return board.getSideToMove() == Color::WHITE ? white : -white;
+}
+
+}
+
+#endif
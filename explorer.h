@@ -0,0 +1,304 @@
+#ifndef CHESS_EXPLORER_H
+#define CHESS_EXPLORER_H
+
+#include "gamedb.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Узел дерева дебютов: позиция и статистика партий через неё
+ */
+struct ExplorerNode {
+    std::uint64_t key;            ///< Ключ Zobrist позиции
+    std::uint32_t whiteWins;      ///< Побед белых
+    std::uint32_t draws;          ///< Ничьих
+    std::uint32_t blackWins;      ///< Побед чёрных
+    std::uint32_t firstEdge;      ///< Номер первого хода из позиции в массиве ходов
+    std::uint16_t edgeCount;      ///< Количество ходов из позиции
+    std::uint16_t averageRating;  ///< Средний рейтинг игроков (0 — неизвестен)
+    std::uint32_t reserved;       ///< Зарезервировано (0)
+
+    std::uint32_t games() const { return whiteWins + draws + blackWins; }
+};
+
+/**
+ * @brief Ход из узла дерева дебютов
+ */
+struct ExplorerEdge {
+    std::uint16_t move;     ///< Ход (Move::raw)
+    std::uint16_t reserved; ///< Зарезервировано (0)
+    std::uint32_t child;    ///< Номер узла позиции после хода
+};
+
+static_assert(sizeof(ExplorerNode) == 32, "Узел дерева дебютов должен занимать 32 байта");
+static_assert(sizeof(ExplorerEdge) == 8, "Ход дерева дебютов должен занимать 8 байт");
+
+namespace detail {
+
+constexpr char EXPLORER_MAGIC[8] = {'C', 'H', 'T', 'R', 'E', 'E', '0', '1'};
+constexpr int EXPLORER_SHARD_BITS = 6;
+
+/// Узел при построении: статистика и ходы с ключами следующих позиций
+struct PartialExplorerNode {
+    std::uint32_t results[3] = {0, 0, 0};
+    std::uint64_t ratingSum = 0;
+    std::uint32_t ratingCount = 0;
+    std::vector<std::pair<Move, std::uint64_t>> edges;
+};
+
+using ExplorerShard = std::unordered_map<std::uint64_t, PartialExplorerNode>;
+
+inline std::size_t explorerShard(std::uint64_t key) { return static_cast<std::size_t>(key >> (64 - EXPLORER_SHARD_BITS)); }
+
+} // namespace detail
+
+/**
+ * @brief Дерево дебютов с учётом перестановок ходов (граф по ключам позиций)
+ *
+ * Узлы хранятся одним массивом, упорядоченным по ключу, ходы — вторым
+ * массивом; ходы узла идут подряд. Поиск позиции — двоичный поиск по ключу.
+ */
+class OpeningExplorer {
+private:
+    std::vector<ExplorerNode> nodes;
+    std::vector<ExplorerEdge> edges;
+
+public:
+    /**
+     * @brief Ход с его статистикой
+     */
+    struct Entry {
+        Move move;
+        const ExplorerNode* node;
+    };
+
+    OpeningExplorer() = default;
+
+    /**
+     * @brief Построить дерево по базе партий
+     * @param database База партий
+     * @param pool Пул потоков
+     * @param maxPlies Глубина дерева в полуходах
+     * @return Дерево дебютов
+     *
+     * Каждый поток строит частичные таблицы для своей части партий,
+     * разбитые на шарды по старшим битам ключа; затем шарды сливаются
+     * параллельно и, поскольку шарды упорядочены по ключу, просто
+     * дописываются друг за другом в общий массив.
+     */
+    static OpeningExplorer build(const GameDatabase& database, ThreadPool& pool, int maxPlies = 30) {
+        constexpr std::size_t shardCount = std::size_t(1) << detail::EXPLORER_SHARD_BITS;
+        std::size_t parts = pool.size();
+        std::size_t chunk = (database.size() + parts - 1) / parts;
+        std::vector<std::vector<detail::ExplorerShard>> partial(parts);
+        std::vector<std::future<void>> tasks;
+        for (std::size_t p = 0; p * chunk < database.size(); ++p) {
+            tasks.push_back(pool.submit([&database, &partial, p, chunk, maxPlies]() {
+                std::vector<detail::ExplorerShard>& shards = partial[p];
+                shards.resize(shardCount);
+                std::vector<std::uint64_t> seen;
+                std::size_t end = std::min(database.size(), (p + 1) * chunk);
+                for (std::size_t id = p * chunk; id < end; ++id) {
+                    const GameEntry& game = database.entry(static_cast<std::uint32_t>(id));
+                    Board board = unpackPosition(game.start);
+                    std::vector<Move> moves = database.moves(static_cast<std::uint32_t>(id));
+                    int outcome = 1 - game.result;
+                    int rated = (game.whiteRating ? 1 : 0) + (game.blackRating ? 1 : 0);
+                    seen.clear();
+                    for (std::size_t ply = 0; ; ++ply) {
+                        std::uint64_t key = board.getKey();
+                        detail::PartialExplorerNode& node = shards[detail::explorerShard(key)][key];
+                        // Перестановка внутри одной партии не учитывается дважды
+                        if (std::find(seen.begin(), seen.end(), key) == seen.end()) {
+                            seen.push_back(key);
+                            ++node.results[outcome];
+                            node.ratingSum += game.whiteRating + game.blackRating;
+                            node.ratingCount += rated;
+                        }
+                        if (ply == moves.size() || ply == static_cast<std::size_t>(maxPlies)) {
+                            break;
+                        }
+                        board.makeMove(moves[ply]);
+                        bool known = false;
+                        for (const auto& edge : node.edges) {
+                            known = known || edge.first == moves[ply];
+                        }
+                        if (!known) {
+                            node.edges.push_back({moves[ply], board.getKey()});
+                        }
+                    }
+                }
+            }));
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+
+        std::vector<std::future<std::vector<std::pair<std::uint64_t, detail::PartialExplorerNode>>>> merged;
+        for (std::size_t s = 0; s < shardCount; ++s) {
+            merged.push_back(pool.submit([&partial, s]() {
+                detail::ExplorerShard total;
+                for (std::vector<detail::ExplorerShard>& shards : partial) {
+                    if (shards.empty()) {
+                        continue;
+                    }
+                    for (auto& item : shards[s]) {
+                        detail::PartialExplorerNode& node = total[item.first];
+                        for (int r = 0; r < 3; ++r) {
+                            node.results[r] += item.second.results[r];
+                        }
+                        node.ratingSum += item.second.ratingSum;
+                        node.ratingCount += item.second.ratingCount;
+                        for (const auto& edge : item.second.edges) {
+                            bool known = false;
+                            for (const auto& existing : node.edges) {
+                                known = known || existing.first == edge.first;
+                            }
+                            if (!known) {
+                                node.edges.push_back(edge);
+                            }
+                        }
+                    }
+                    detail::ExplorerShard().swap(shards[s]);
+                }
+                std::vector<std::pair<std::uint64_t, detail::PartialExplorerNode>> sorted(
+                    std::make_move_iterator(total.begin()), std::make_move_iterator(total.end()));
+                std::sort(sorted.begin(), sorted.end(),
+                          [](const auto& a, const auto& b) { return a.first < b.first; });
+                return sorted;
+            }));
+        }
+
+        OpeningExplorer explorer;
+        std::vector<std::uint64_t> childKeys;
+        for (auto& future : merged) {
+            for (const auto& item : future.get()) {
+                const detail::PartialExplorerNode& node = item.second;
+                ExplorerNode compact{item.first, node.results[0], node.results[1], node.results[2],
+                                     static_cast<std::uint32_t>(explorer.edges.size()),
+                                     static_cast<std::uint16_t>(node.edges.size()),
+                                     static_cast<std::uint16_t>(node.ratingCount ? node.ratingSum / node.ratingCount : 0),
+                                     0};
+                explorer.nodes.push_back(compact);
+                for (const auto& edge : node.edges) {
+                    explorer.edges.push_back({edge.first.raw(), 0, 0});
+                    childKeys.push_back(edge.second);
+                }
+            }
+        }
+        for (std::size_t e = 0; e < explorer.edges.size(); ++e) {
+            explorer.edges[e].child = static_cast<std::uint32_t>(explorer.indexOf(childKeys[e]));
+        }
+        return explorer;
+    }
+
+    /**
+     * @brief Загрузить дерево из файла
+     * @param path Путь к файлу, записанному write()
+     * @return Дерево дебютов
+     * @throws std::runtime_error если файл отсутствует или повреждён
+     */
+    static OpeningExplorer load(const std::string& path) {
+        MappedFile file(path);
+        std::size_t count = detail::checkHeader(file, detail::EXPLORER_MAGIC, sizeof(ExplorerNode));
+        const std::uint8_t* data = file.bytes() + sizeof(detail::FileHeader);
+        std::size_t edgeBytes = file.size() - sizeof(detail::FileHeader) - count * sizeof(ExplorerNode);
+        OpeningExplorer explorer;
+        explorer.nodes.resize(count);
+        explorer.edges.resize(edgeBytes / sizeof(ExplorerEdge));
+        std::memcpy(explorer.nodes.data(), data, count * sizeof(ExplorerNode));
+        std::memcpy(explorer.edges.data(), data + count * sizeof(ExplorerNode),
+                    explorer.edges.size() * sizeof(ExplorerEdge));
+        for (const ExplorerNode& node : explorer.nodes) {
+            if (std::size_t(node.firstEdge) + node.edgeCount > explorer.edges.size()) {
+                throw std::runtime_error("Файл дерева дебютов повреждён");
+            }
+        }
+        for (const ExplorerEdge& edge : explorer.edges) {
+            if (edge.child >= count) {
+                throw std::runtime_error("Файл дерева дебютов повреждён");
+            }
+        }
+        return explorer;
+    }
+
+    /**
+     * @brief Записать дерево в файл
+     * @param path Путь к файлу
+     * @throws std::runtime_error при ошибке записи
+     */
+    void write(const std::string& path) const {
+        detail::writeFile(path, detail::EXPLORER_MAGIC, nodes.size(),
+                          nodes.data(), nodes.size() * sizeof(ExplorerNode),
+                          edges.data(), edges.size() * sizeof(ExplorerEdge));
+    }
+
+    /**
+     * @brief Количество узлов
+     * @return Число различных позиций в дереве
+     */
+    std::size_t size() const { return nodes.size(); }
+
+    /**
+     * @brief Номер узла позиции
+     * @param key Ключ Zobrist позиции
+     * @return Номер узла или size(), если позиции нет в дереве
+     */
+    std::size_t indexOf(std::uint64_t key) const {
+        auto found = std::lower_bound(nodes.begin(), nodes.end(), key,
+                                      [](const ExplorerNode& node, std::uint64_t k) { return node.key < k; });
+        return found != nodes.end() && found->key == key ? static_cast<std::size_t>(found - nodes.begin()) : nodes.size();
+    }
+
+    /**
+     * @brief Узел позиции
+     * @param board Позиция
+     * @return Узел или nullptr, если позиции нет в дереве
+     */
+    const ExplorerNode* find(const Board& board) const {
+        std::size_t index = indexOf(board.getKey());
+        return index < nodes.size() ? &nodes[index] : nullptr;
+    }
+
+    /**
+     * @brief Ходы из позиции со статистикой
+     * @param board Позиция
+     * @return Ходы, упорядоченные по убыванию числа партий
+     *
+     * Статистика хода — статистика позиции после него, включая партии,
+     * пришедшие в неё другим порядком ходов.
+     */
+    std::vector<Entry> moves(const Board& board) const {
+        std::vector<Entry> result;
+        const ExplorerNode* node = find(board);
+        if (!node) {
+            return result;
+        }
+        for (std::uint32_t e = node->firstEdge; e < node->firstEdge + node->edgeCount; ++e) {
+            result.push_back({Move::fromRaw(edges[e].move), &nodes[edges[e].child]});
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const Entry& a, const Entry& b) { return a.node->games() > b.node->games(); });
+        return result;
+    }
+};
+
+}
+
+#endif
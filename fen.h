@@ -0,0 +1,167 @@
+#ifndef CHESS_FEN_H
+#define CHESS_FEN_H
+
+#include "movegen.h"
+
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/// Начальная расстановка без пешек
+inline const char* const PAWNLESS_START_FEN = "rnbqkbnr/8/8/8/8/8/8/RNBQKBNR w - - 0 1";
+
+/**
+ * @brief Разобрать позицию в нотации FEN
+ * @param fen Строка FEN; поля счётчиков ходов необязательны
+ * @return Доска с позицией
+ * @throws std::invalid_argument если запись некорректна или содержит пешки,
+ *         права на рокировку или взятие на проходе
+ *
+ * Иерархия фигур не содержит пешек и не моделирует рокировку, поэтому
+ * третье и четвёртое поля должны быть "-". Карман варианта crazyhouse
+ * записывается в квадратных скобках после расстановки: "8/.../8[Nnq]".
+ */
+inline Board parseFen(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling = "-", enPassant = "-";
+    int halfmoves = 0, fullmoves = 1;
+    if (!(in >> placement >> side)) {
+        throw std::invalid_argument("FEN должен содержать расстановку и очередь хода");
+    }
+    in >> castling >> enPassant;
+    if (!(in >> halfmoves)) halfmoves = 0;
+    if (!(in >> fullmoves)) fullmoves = 1;
+
+    std::string pocketText;
+    std::size_t bracket = placement.find('[');
+    if (bracket != std::string::npos) {
+        if (placement.back() != ']') {
+            throw std::invalid_argument("Незакрытая скобка кармана в FEN");
+        }
+        pocketText = placement.substr(bracket + 1, placement.size() - bracket - 2);
+        placement.resize(bracket);
+    }
+    Board board(bracket != std::string::npos ? Board::Variant::CRAZYHOUSE
+                                             : Board::Variant::STANDARD);
+
+    int x = 0, y = 7;
+    for (char c : placement) {
+        PieceKind kind;
+        if (c == '/') {
+            if (x != 8 || y == 0) {
+                throw std::invalid_argument("Некорректная горизонталь в FEN");
+            }
+            x = 0;
+            --y;
+        } else if (c >= '1' && c <= '8') {
+            x += c - '0';
+        } else if (parsePieceLetter(c, kind)) {
+            if (x > 7) {
+                throw std::invalid_argument("Горизонталь в FEN длиннее 8 клеток");
+            }
+            board.putPiece(c >= 'a' ? Color::BLACK : Color::WHITE, kind, makeSquare(x, y));
+            ++x;
+        } else if (c == 'p' || c == 'P') {
+            throw std::invalid_argument("Пешки не поддерживаются иерархией фигур");
+        } else {
+            throw std::invalid_argument(std::string("Недопустимый символ в FEN: ") + c);
+        }
+        if (x > 8) {
+            throw std::invalid_argument("Горизонталь в FEN длиннее 8 клеток");
+        }
+    }
+    if (x != 8 || y != 0) {
+        throw std::invalid_argument("Расстановка в FEN должна содержать 8 горизонталей");
+    }
+
+    for (char c : pocketText) {
+        PieceKind kind;
+        if (!parsePieceLetter(c, kind)) {
+            throw std::invalid_argument(std::string("Недопустимая фигура в кармане: ") + c);
+        }
+        board.addToPocket(c >= 'a' ? Color::BLACK : Color::WHITE, kind);
+    }
+
+    if (side == "w") {
+        board.setSideToMove(Color::WHITE);
+    } else if (side == "b") {
+        board.setSideToMove(Color::BLACK);
+    } else {
+        throw std::invalid_argument("Очередь хода в FEN должна быть w или b");
+    }
+    if (castling != "-" || enPassant != "-") {
+        throw std::invalid_argument("Рокировка и взятие на проходе не поддерживаются");
+    }
+    board.setMoveCounters(halfmoves, fullmoves);
+    return board;
+}
+
+/// Наибольшая длина записи FEN: доска, полные карманы, очередь хода и два счётчика
+constexpr std::size_t FEN_MAX_LENGTH = 64 + 7 + 2 + 2 * PIECE_KIND_COUNT * POCKET_LIMIT + 7 + 2 * 11 + 1;
+
+/**
+ * @brief Записать позицию в нотации FEN в буфер без выделения памяти
+ * @param out Буфер не короче FEN_MAX_LENGTH байт
+ * @param board Позиция
+ * @return Указатель за последним записанным символом (завершающий ноль не пишется)
+ */
+inline char* formatFen(char* out, const Board& board) {
+    for (int y = 7; y >= 0; --y) {
+        int empty = 0;
+        for (int x = 0; x < 8; ++x) {
+            int sq = makeSquare(x, y);
+            if (board.isEmpty(sq)) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) {
+                *out++ = static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            *out++ = pieceLetter(board.kindAt(sq), board.colorAt(sq));
+        }
+        if (empty > 0) {
+            *out++ = static_cast<char>('0' + empty);
+        }
+        if (y > 0) {
+            *out++ = '/';
+        }
+    }
+    if (board.getVariant() == Board::Variant::CRAZYHOUSE) {
+        *out++ = '[';
+        for (Color col : {Color::WHITE, Color::BLACK}) {
+            for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+                PieceKind kind = static_cast<PieceKind>(k);
+                out = std::fill_n(out, board.getPocketCount(col, kind), pieceLetter(kind, col));
+            }
+        }
+        *out++ = ']';
+    }
+    const char* side = board.getSideToMove() == Color::WHITE ? " w - - " : " b - - ";
+    out = std::copy(side, side + 7, out);
+    out = std::to_chars(out, out + 11, board.getHalfmoveClock()).ptr;
+    *out++ = ' ';
+    return std::to_chars(out, out + 11, board.getFullmoveNumber()).ptr;
+}
+
+/**
+ * @brief Записать позицию в нотации FEN
+ * @param board Позиция
+ * @return Строка FEN со всеми шестью полями
+ */
+inline std::string toFen(const Board& board) {
+    char buffer[FEN_MAX_LENGTH];
+    return std::string(buffer, formatFen(buffer, board));
+}
+
+}
+
+#endif
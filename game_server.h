@@ -0,0 +1,455 @@
+#ifndef CHESS_GAME_SERVER_H
+#define CHESS_GAME_SERVER_H
+
+#include "datagen.h"
+#include "fen.h"
+#include "match.h"
+#include "movecache.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+using GameId = std::uint64_t; ///< Идентификатор партии на сервере
+
+/**
+ * @brief Пул объектов Board
+ *
+ * Доски выделяются блоками и возвращаются в список свободных, поэтому
+ * создание и завершение партий не обращаются к куче.
+ */
+class BoardPool {
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Board[]>> blocks;
+    std::vector<Board*> freeList;
+    std::size_t blockSize;
+
+public:
+    /**
+     * @brief Конструктор пула
+     * @param boardsPerBlock Количество досок в одном блоке
+     */
+    explicit BoardPool(std::size_t boardsPerBlock = 256) : blockSize(boardsPerBlock) {}
+
+    BoardPool(const BoardPool&) = delete;
+    BoardPool& operator=(const BoardPool&) = delete;
+
+    /**
+     * @brief Взять доску из пула
+     * @param initial Позиция, которая записывается в доску
+     * @return Доска, принадлежащая пулу
+     */
+    Board* acquire(const Board& initial) {
+        Board* board;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (freeList.empty()) {
+                blocks.emplace_back(new Board[blockSize]);
+                for (std::size_t i = blockSize; i-- > 0; ) {
+                    freeList.push_back(&blocks.back()[i]);
+                }
+            }
+            board = freeList.back();
+            freeList.pop_back();
+        }
+        *board = initial;
+        return board;
+    }
+
+    /**
+     * @brief Вернуть доску в пул
+     * @param board Доска, полученная от acquire()
+     */
+    void release(Board* board) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeList.push_back(board);
+    }
+
+    /**
+     * @brief Общее число досок в пуле
+     * @return Выделено досок (занятых и свободных)
+     */
+    std::size_t capacity() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return blocks.size() * blockSize;
+    }
+};
+
+/**
+ * @brief Итог обработки присланного хода
+ */
+enum class MoveOutcome {
+    ACCEPTED,      /**< Ход сделан */
+    NOT_YOUR_TURN, /**< Ход прислал игрок, чья очередь не наступила */
+    ILLEGAL,       /**< Ход незаконен */
+    GAME_OVER      /**< Партия уже завершена */
+};
+
+/**
+ * @brief Ход, присланный игроком
+ */
+struct MoveSubmission {
+    Color player = Color::WHITE;
+    Move move;
+};
+
+/**
+ * @brief Событие обработки хода для подписчиков
+ */
+struct MoveEvent {
+    GameId game = 0;
+    std::uint32_t ply = 0;       ///< Номер полухода после обработки
+    Color player = Color::WHITE;
+    Move move;
+    MoveOutcome outcome = MoveOutcome::ACCEPTED;
+    int captured = -1;           ///< Вид взятой фигуры (PieceKind) или -1
+    bool check = false;          ///< Ход объявил шах
+    bool finished = false;       ///< Партия завершилась этим ходом
+    GameResult result = GameResult::DRAW;
+};
+
+/**
+ * @brief Состояние партии на момент запроса
+ */
+struct GameSnapshot {
+    Board board;
+    std::uint32_t plies = 0;
+    bool finished = false;
+    GameResult result = GameResult::DRAW;
+    std::string reason;
+};
+
+/**
+ * @brief Партия на сервере
+ *
+ * Ходы принимаются через очереди SPSC без блокировок, по одной на цвет:
+ * писатель каждой — поток, обслуживающий соединение этого игрока, читатель —
+ * поток, обрабатывающий шард партии в GameManager. Обработчик сначала берёт
+ * ход стороны, чья очередь, поэтому предварительный ход соперника, присланный
+ * до обработки хода, не отклоняется из-за порядка очередей. Позиция защищена
+ * собственным мьютексом партии, который берут только обработчик и запросы снимков.
+ */
+class LiveGame {
+    friend class GameManager;
+
+private:
+    GameId id;
+    BoardPool& pool;
+    Board* board;
+    std::vector<std::uint64_t> history;
+    SpscQueue<MoveSubmission, 64> inbox[COLOR_COUNT];   // по очереди на цвет
+    mutable std::mutex state;
+    std::uint32_t plies;
+    bool finished;
+    GameResult result;
+    std::string reason;
+
+public:
+    LiveGame(GameId gameId, BoardPool& boardPool, const Board& start)
+    : id(gameId), pool(boardPool), board(boardPool.acquire(start)), plies(0), finished(false),
+      result(GameResult::DRAW) {}
+
+    LiveGame(const LiveGame&) = delete;
+    LiveGame& operator=(const LiveGame&) = delete;
+
+    ~LiveGame() { pool.release(board); }
+
+    /**
+     * @brief Прислать ход (только поток-писатель игрока player)
+     * @param player Цвет игрока
+     * @param move Ход
+     * @return false если очередь игрока заполнена
+     */
+    bool submit(Color player, Move move) { return inbox[colorIndex(player)].push({player, move}); }
+
+    /**
+     * @brief Идентификатор партии
+     * @return Номер партии
+     */
+    GameId getId() const { return id; }
+};
+
+/**
+ * @brief Менеджер партий сервера
+ *
+ * Таблица партий разбита на шарды по идентификатору, у каждого шарда
+ * своя блокировка чтения-записи: создание и удаление партий в разных
+ * шардах не мешают друг другу, а поиск берёт только разделяемую блокировку.
+ * Обработка ходов идёт по шардам; один шард в каждый момент обрабатывает
+ * не более одного потока, что делает его читателем очередей всех партий шарда.
+ */
+class GameManager {
+public:
+    static constexpr std::size_t SHARD_COUNT = 64; ///< Количество шардов таблицы партий
+
+    using MoveListener = std::function<void(const MoveEvent&, const Board&)>;
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<GameId, std::shared_ptr<LiveGame>> games;
+        std::atomic<bool> processing{false};
+    };
+
+    BoardPool pool;
+    LegalMoveCache moveCache;
+    Shard shards[SHARD_COUNT];
+    std::atomic<GameId> nextId{1};
+    MoveListener listener;
+
+    Shard& shardOf(GameId id) { return shards[id % SHARD_COUNT]; }
+    const Shard& shardOf(GameId id) const { return shards[id % SHARD_COUNT]; }
+
+    /**
+     * @brief Применить присланный ход (вызывается под мьютексом партии)
+     */
+    void apply(LiveGame& game, const MoveSubmission& submission, MoveEvent& event) {
+        Board& board = *game.board;
+        event.game = game.id;
+        event.player = submission.player;
+        event.move = submission.move;
+        if (game.finished) {
+            event.outcome = MoveOutcome::GAME_OVER;
+        } else if (submission.player != board.getSideToMove()) {
+            event.outcome = MoveOutcome::NOT_YOUR_TURN;
+        } else if (!isPseudoLegal(board, submission.move) || !isLegal(board, submission.move)) {
+            event.outcome = MoveOutcome::ILLEGAL;
+        } else {
+            event.outcome = MoveOutcome::ACCEPTED;
+            event.captured = isCapture(board, submission.move) ? static_cast<int>(board.kindAt(submission.move.to())) : -1;
+            game.history.push_back(board.getKey());
+            board.makeMove(submission.move);
+            ++game.plies;
+            event.check = board.inCheck(board.getSideToMove());
+
+            // Заодно кэшируем ходы новой позиции: клиенты запросят их первыми
+            MoveList legal;
+            moveCache.generate(board, legal);
+            if (legal.size == 0) {
+                game.finished = true;
+                game.result = !event.check ? GameResult::DRAW
+                            : board.getSideToMove() == Color::WHITE ? GameResult::BLACK_WIN : GameResult::WHITE_WIN;
+                game.reason = event.check ? "мат" : "пат";
+            } else if (isRuleDraw(board, game.history, game.reason)) {
+                game.finished = true;
+                game.result = GameResult::DRAW;
+            }
+        }
+        event.ply = game.plies;
+        event.finished = game.finished;
+        event.result = game.result;
+    }
+
+public:
+    /**
+     * @brief Конструктор
+     * @param moveCacheMegabytes Размер кэша законных ходов
+     */
+    explicit GameManager(std::size_t moveCacheMegabytes = 4) : moveCache(moveCacheMegabytes) {}
+
+    GameManager(const GameManager&) = delete;
+    GameManager& operator=(const GameManager&) = delete;
+
+    /**
+     * @brief Задать обработчик событий ходов
+     * @param callback Вызывается потоком обработки шарда под мьютексом партии
+     *                 для каждого присланного хода; должен работать быстро
+     *
+     * Задаётся до начала обработки ходов.
+     */
+    void setMoveListener(MoveListener callback) { listener = std::move(callback); }
+
+    /**
+     * @brief Создать партию
+     * @param start Начальная позиция
+     * @return Идентификатор партии
+     */
+    GameId createGame(const Board& start) {
+        GameId id = nextId.fetch_add(1, std::memory_order_relaxed);
+        auto game = std::make_shared<LiveGame>(id, pool, start);
+        Shard& shard = shardOf(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.games.emplace(id, std::move(game));
+        return id;
+    }
+
+    /**
+     * @brief Создать партию из начальной расстановки без пешек
+     * @return Идентификатор партии
+     */
+    GameId createGame() { return createGame(parseFen(PAWNLESS_START_FEN)); }
+
+    /**
+     * @brief Удалить партию
+     * @param id Идентификатор
+     * @return false если партии нет
+     *
+     * Доска возвращается в пул, когда будет отпущена последняя ссылка на партию.
+     */
+    bool removeGame(GameId id) {
+        Shard& shard = shardOf(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.games.erase(id) > 0;
+    }
+
+    /**
+     * @brief Найти партию
+     * @param id Идентификатор
+     * @return Партия или пустой указатель
+     *
+     * Поток соединения может сохранить указатель и присылать ходы
+     * через LiveGame::submit, не обращаясь больше к таблице партий.
+     */
+    std::shared_ptr<LiveGame> find(GameId id) const {
+        const Shard& shard = shardOf(id);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.games.find(id);
+        return found == shard.games.end() ? nullptr : found->second;
+    }
+
+    /**
+     * @brief Прислать ход
+     * @param id Идентификатор партии
+     * @param player Цвет игрока
+     * @param move Ход
+     * @return false если партии нет или очередь игрока заполнена
+     *
+     * Ходы одного цвета одной партии присылает не более одного потока
+     * одновременно (у каждого игрока своя очередь SPSC); белые и чёрные
+     * могут присылать ходы из разных потоков.
+     */
+    bool submitMove(GameId id, Color player, Move move) {
+        std::shared_ptr<LiveGame> game = find(id);
+        return game && game->submit(player, move);
+    }
+
+    /**
+     * @brief Обработать присланные ходы всех партий шарда
+     * @param index Номер шарда
+     * @return Количество обработанных ходов (0, если шард уже обрабатывается другим потоком)
+     */
+    std::size_t processShard(std::size_t index) {
+        Shard& shard = shards[index];
+        if (shard.processing.exchange(true, std::memory_order_acquire)) {
+            return 0;
+        }
+        struct Release {
+            std::atomic<bool>& flag;
+            ~Release() { flag.store(false, std::memory_order_release); }
+        } release{shard.processing};
+        std::vector<std::shared_ptr<LiveGame>> games;
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            games.reserve(shard.games.size());
+            for (const auto& item : shard.games) {
+                games.push_back(item.second);
+            }
+        }
+        std::size_t processed = 0;
+        MoveSubmission submission;
+        for (const std::shared_ptr<LiveGame>& game : games) {
+            for (;;) {
+                std::lock_guard<std::mutex> lock(game->state);
+                int turn = colorIndex(game->board->getSideToMove());
+                if (!game->inbox[turn].pop(submission) && !game->inbox[1 - turn].pop(submission)) {
+                    break;
+                }
+                MoveEvent event;
+                apply(*game, submission, event);
+                if (listener) {
+                    listener(event, *game->board);
+                }
+                ++processed;
+            }
+        }
+        return processed;
+    }
+
+    /**
+     * @brief Обработать присланные ходы всех шардов
+     * @return Количество обработанных ходов
+     */
+    std::size_t processAll() {
+        std::size_t processed = 0;
+        for (std::size_t s = 0; s < SHARD_COUNT; ++s) {
+            processed += processShard(s);
+        }
+        return processed;
+    }
+
+    /**
+     * @brief Снимок состояния партии
+     * @param id Идентификатор
+     * @param[out] snapshot Позиция и итог партии
+     * @return false если партии нет
+     */
+    bool snapshot(GameId id, GameSnapshot& snapshot) const {
+        std::shared_ptr<LiveGame> game = find(id);
+        if (!game) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(game->state);
+        snapshot.board = *game->board;
+        snapshot.plies = game->plies;
+        snapshot.finished = game->finished;
+        snapshot.result = game->result;
+        snapshot.reason = game->reason;
+        return true;
+    }
+
+    /**
+     * @brief Законные ходы текущей позиции партии (подсветка, проверка предварительных ходов)
+     * @param id Идентификатор
+     * @param[out] list Законные ходы
+     * @return false если партии нет
+     *
+     * Повторные запросы одной позиции обслуживаются из кэша без генерации.
+     */
+    bool legalMoves(GameId id, MoveList& list) {
+        std::shared_ptr<LiveGame> game = find(id);
+        if (!game) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(game->state);
+        moveCache.generate(*game->board, list);
+        return true;
+    }
+
+    /**
+     * @brief Количество партий на сервере
+     * @return Число партий во всех шардах
+     */
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const Shard& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.games.size();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Количество досок в пуле
+     * @return Выделено досок
+     */
+    std::size_t boardCapacity() { return pool.capacity(); }
+};
+
+}
+
+#endif
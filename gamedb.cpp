@@ -0,0 +1,230 @@
+/**
+ * @file gamedb.cpp
+ * @brief Построение базы партий и поиск партий по позиции
+ *
+ * Команды:
+ *   gamedb build <база> <партии.txt> — построить базу из текстового файла;
+ *   gamedb find <база> <FEN>        — найти партии, в которых встретилась позиция;
+ *   gamedb index-material <база> [потоков]  — построить индекс материала <база>.mat;
+ *   gamedb material <база> <шаблон> [потоков] — найти партии по материалу,
+ *     например KRvKR или KQ+vK+ (см. parseMaterialPattern);
+ *   gamedb build-explorer <база> [полуходов] [потоков] — построить дерево дебютов <база>.tree;
+ *   gamedb explore <база> <FEN>     — ходы из позиции со статистикой по дереву дебютов;
+ *   gamedb analyze <база> <первая> <количество> [глубина] [потоков] — разобрать партии
+ *     и отметить ошибки ("?") и грубые ошибки ("??").
+ *
+ * Строка файла партий: "результат;рейтинг белых;рейтинг чёрных;FEN;ходы SAN",
+ * где результат — 1-0, 0-1 или 1/2-1/2, а пустой FEN означает начальную
+ * расстановку без пешек. Пустые строки и строки с '#' пропускаются.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread gamedb.cpp -o gamedb
+ */
+#include "analysis.h"
+#include "datagen.h"
+#include "fen.h"
+#include "explorer.h"
+#include "gamedb.h"
+#include "material.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+vector<string> splitFields(const string& line, char separator) {
+    vector<string> fields;
+    stringstream stream(line);
+    string field;
+    while (getline(stream, field, separator)) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+Chess::GameResult parseResult(const string& text) {
+    if (text == "1-0") return Chess::GameResult::WHITE_WIN;
+    if (text == "0-1") return Chess::GameResult::BLACK_WIN;
+    if (text == "1/2-1/2") return Chess::GameResult::DRAW;
+    throw invalid_argument("Неизвестный результат: " + text);
+}
+
+int build(const string& base, const string& path) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Не удалось открыть " << path << '\n';
+        return 1;
+    }
+    auto begin = chrono::steady_clock::now();
+    Chess::GameDatabaseWriter writer;
+    string line;
+    size_t lineNumber = 0, skipped = 0, plies = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        try {
+            vector<string> fields = splitFields(line, ';');
+            if (fields.size() < 5) {
+                throw invalid_argument("Ожидается 5 полей");
+            }
+            Chess::Board board = Chess::parseFen(fields[3].empty() ? Chess::PAWNLESS_START_FEN : fields[3]);
+            const Chess::Board start = board;
+            vector<Chess::Move> moves;
+            istringstream sans(fields[4]);
+            string san;
+            while (sans >> san) {
+                Chess::Move move = Chess::parseSan(board, san);
+                board.makeMove(move);
+                moves.push_back(move);
+            }
+            writer.addGame(start, moves, parseResult(fields[0]), stoi(fields[1]), stoi(fields[2]));
+            plies += moves.size();
+        } catch (const exception& e) {
+            ++skipped;
+            cerr << path << ':' << lineNumber << ": " << e.what() << '\n';
+        }
+    }
+    writer.write(base);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "Партий: " << writer.size() << ", полуходов: " << plies << ", пропущено строк: " << skipped
+         << " за " << seconds << " с\n";
+    return 0;
+}
+
+int find(const string& base, const string& fen) {
+    Chess::GameDatabase database(base);
+    Chess::Board board = Chess::parseFen(fen);
+    auto begin = chrono::steady_clock::now();
+    auto range = database.positionEntries(board.getKey());
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    cout << "Найдено партий: " << (range.second - range.first) << " за " << micros << " мкс\n";
+    for (const Chess::PositionIndexEntry* e = range.first; e != range.second; ++e) {
+        const Chess::GameEntry& game = database.entry(e->game);
+        cout << "Партия " << e->game << ", полуход " << e->ply << ", результат "
+             << (game.result > 0 ? "1-0" : game.result < 0 ? "0-1" : "1/2-1/2") << '\n';
+    }
+    return 0;
+}
+
+int indexMaterial(const string& base, unsigned threads) {
+    Chess::GameDatabase database(base);
+    Chess::ThreadPool pool(threads);
+    auto begin = chrono::steady_clock::now();
+    Chess::writeMaterialIndex(database, base + ".mat", pool);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "Индекс материала построен по " << database.size() << " партиям за " << seconds << " с\n";
+    return 0;
+}
+
+int material(const string& base, const string& text, unsigned threads) {
+    Chess::MaterialIndex index(base + ".mat");
+    Chess::MaterialPattern pattern = Chess::parseMaterialPattern(text);
+    Chess::ThreadPool pool(threads);
+    auto begin = chrono::steady_clock::now();
+    vector<uint32_t> games = index.findGames(pattern, pool);
+    double millis = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    cout << "Найдено партий: " << games.size() << " за " << millis << " мс\n";
+    for (size_t i = 0; i < games.size() && i < 20; ++i) {
+        cout << "Партия " << games[i] << '\n';
+    }
+    return 0;
+}
+
+int buildExplorer(const string& base, int plies, unsigned threads) {
+    Chess::GameDatabase database(base);
+    Chess::ThreadPool pool(threads);
+    auto begin = chrono::steady_clock::now();
+    Chess::OpeningExplorer explorer = Chess::OpeningExplorer::build(database, pool, plies);
+    explorer.write(base + ".tree");
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout << "Дерево дебютов: " << explorer.size() << " позиций за " << seconds << " с\n";
+    return 0;
+}
+
+int explore(const string& base, const string& fen) {
+    Chess::OpeningExplorer explorer = Chess::OpeningExplorer::load(base + ".tree");
+    Chess::Board board = Chess::parseFen(fen);
+    auto begin = chrono::steady_clock::now();
+    vector<Chess::OpeningExplorer::Entry> moves = explorer.moves(board);
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    cout << "Ходов: " << moves.size() << " за " << micros << " мкс\n";
+    for (const Chess::OpeningExplorer::Entry& entry : moves) {
+        const Chess::ExplorerNode& node = *entry.node;
+        cout << Chess::moveToSan(board, entry.move) << ": партий " << node.games()
+             << ", +" << node.whiteWins << " =" << node.draws << " -" << node.blackWins
+             << ", средний рейтинг " << node.averageRating << '\n';
+    }
+    return 0;
+}
+
+int analyze(const string& base, uint32_t first, uint32_t count, int depth, unsigned threads) {
+    Chess::GameDatabase database(base);
+    vector<Chess::GameToAnalyze> games;
+    for (uint32_t id = first; id < first + count && id < database.size(); ++id) {
+        games.push_back({Chess::unpackPosition(database.entry(id).start), database.moves(id)});
+    }
+    Chess::AnalysisOptions options;
+    options.limits.depth = depth;
+    Chess::ThreadPool pool(threads);
+    Chess::TranspositionTable table(64);
+    auto begin = chrono::steady_clock::now();
+    vector<vector<Chess::PlyAnalysis>> analyses = Chess::analyzeGames(games, options, pool, table);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    for (size_t g = 0; g < games.size(); ++g) {
+        cout << "Партия " << first + g << ":";
+        Chess::Board board = games[g].start;
+        for (const Chess::PlyAnalysis& ply : analyses[g]) {
+            cout << ' ' << Chess::moveToSan(board, ply.move);
+            if (ply.annotation != Chess::MoveAnnotation::NONE) {
+                cout << (ply.annotation == Chess::MoveAnnotation::BLUNDER ? "??" : "?")
+                     << " (" << Chess::moveToSan(board, ply.bestMove) << ", -" << ply.loss << ")";
+            }
+            board.makeMove(ply.move);
+        }
+        cout << '\n';
+    }
+    cout << "Разобрано партий: " << games.size() << " за " << seconds << " с\n";
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Использование: " << argv[0] << " build <база> <партии.txt>\n"
+             << "               " << argv[0] << " find <база> <FEN>\n"
+             << "               " << argv[0] << " index-material <база> [потоков]\n"
+             << "               " << argv[0] << " material <база> <шаблон> [потоков]\n"
+             << "               " << argv[0] << " build-explorer <база> [полуходов] [потоков]\n"
+             << "               " << argv[0] << " explore <база> <FEN>\n"
+             << "               " << argv[0] << " analyze <база> <первая> <количество> [глубина] [потоков]\n";
+        return 1;
+    }
+    try {
+        string command = argv[1];
+        if (command == "build" && argc > 3) return build(argv[2], argv[3]);
+        if (command == "find" && argc > 3) return find(argv[2], argv[3]);
+        if (command == "index-material") return indexMaterial(argv[2], argc > 3 ? stoul(argv[3]) : 0);
+        if (command == "build-explorer") {
+            return buildExplorer(argv[2], argc > 3 ? stoi(argv[3]) : 30, argc > 4 ? stoul(argv[4]) : 0);
+        }
+        if (command == "explore" && argc > 3) return explore(argv[2], argv[3]);
+        if (command == "analyze" && argc > 4) {
+            return analyze(argv[2], stoul(argv[3]), stoul(argv[4]), argc > 5 ? stoi(argv[5]) : 4,
+                           argc > 6 ? stoul(argv[6]) : 0);
+        }
+        if (command == "material" && argc > 3) return material(argv[2], argv[3], argc > 4 ? stoul(argv[4]) : 0);
+        cerr << "Неизвестная команда или не хватает аргументов: " << command << '\n';
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+    }
+    return 1;
+}
@@ -0,0 +1,627 @@
+#ifndef CHESS_GAMEDB_H
+#define CHESS_GAMEDB_H
+
+#include "eval.h"
+#include "match.h"
+#include "movegen.h"
+#include "packed.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+namespace detail {
+
+/**
+ * @brief Последовательная запись битовых полей (младшие биты первыми)
+ */
+class BitWriter {
+private:
+    std::vector<std::uint8_t>& out;
+    std::uint64_t accumulator = 0;
+    int filled = 0;
+
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& bytes) : out(bytes) {}
+
+    void write(std::uint32_t value, int bits) {
+        accumulator |= std::uint64_t(value) << filled;
+        filled += bits;
+        while (filled >= 8) {
+            out.push_back(static_cast<std::uint8_t>(accumulator));
+            accumulator >>= 8;
+            filled -= 8;
+        }
+    }
+
+    void finish() {
+        if (filled > 0) {
+            out.push_back(static_cast<std::uint8_t>(accumulator));
+        }
+        accumulator = 0;
+        filled = 0;
+    }
+};
+
+/**
+ * @brief Последовательное чтение битов, записанных BitWriter
+ *
+ * Декодер читает наперёд, поэтому за концом данных выдаются нули;
+ * правильный код никогда не заглядывает дальше 32 бит за конец.
+ */
+class BitReader {
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t position = 0;
+
+public:
+    BitReader(const std::uint8_t* bytes, std::size_t length) : data(bytes), size(length) {}
+
+    std::uint32_t readBit() {
+        std::size_t byte = position >> 3;
+        if (byte >= size) {
+            if (position++ >= size * 8 + 32) {
+                throw std::runtime_error("Запись партии повреждена");
+            }
+            return 0;
+        }
+        return (data[byte] >> (position++ & 7)) & 1;
+    }
+};
+
+/// Границы интервала арифметического кодера (32 бита)
+constexpr std::uint64_t CODE_TOP = (std::uint64_t(1) << 32) - 1;
+constexpr std::uint64_t CODE_HALF = std::uint64_t(1) << 31;
+constexpr std::uint64_t CODE_QUARTER = std::uint64_t(1) << 30;
+
+using RankTable = std::array<std::uint32_t, MAX_MOVES + 1>;
+
+/**
+ * @brief Накопленные частоты номеров ходов в упорядоченном списке
+ * @return cumulative[r] — сумма частот номеров меньше r
+ *
+ * Частота номера r пропорциональна 1/(r + 2): ход из начала списка
+ * стоит 2-3 бита, из конца — на 1-2 бита больше равномерного кода.
+ */
+constexpr RankTable makeRankCumulative() {
+    RankTable cumulative{};
+    for (int r = 0; r < MAX_MOVES; ++r) {
+        cumulative[r + 1] = cumulative[r] + std::max(4096 / (r + 2), 1);
+    }
+    return cumulative;
+}
+
+inline constexpr RankTable RANK_CUMULATIVE = makeRankCumulative();
+
+/**
+ * @brief Упорядочить законные ходы от вероятных к маловероятным
+ * @param board Позиция
+ * @param[in,out] list Законные ходы в порядке generateLegalMoves
+ *
+ * Взятия ценных фигур и уход из-под удара — вверх, ход на поле, которое
+ * бьёт соперник, — вниз; при равенстве сохраняется порядок генерации.
+ * Кодер и декодер вызывают функцию для одной и той же позиции.
+ */
+inline void orderMovesForCoding(const Board& board, MoveList& list) {
+    Color them = opposite(board.getSideToMove());
+    int scores[MAX_MOVES];
+    for (int i = 0; i < list.size; ++i) {
+        Move move = list[i];
+        int to = move.to();
+        int mover = static_cast<int>(move.isDrop() ? move.dropKind() : board.kindAt(move.from()));
+        int score = 0;
+        if (isCapture(board, move)) {
+            score += PIECE_VALUES[static_cast<int>(board.kindAt(to))];
+        }
+        if (!move.isDrop() && board.attackerCount(move.from(), them) > 0) {
+            score += PIECE_VALUES[mover];
+        }
+        if (board.attackerCount(to, them) > 0) {
+            score -= PIECE_VALUES[mover];
+        }
+        int j = i;
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            list[j] = list[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        list[j] = move;
+        scores[j] = score;
+    }
+}
+
+/**
+ * @brief Арифметический кодер номеров ходов
+ */
+class RankEncoder {
+private:
+    BitWriter writer;
+    std::uint64_t low = 0, high = CODE_TOP;
+    int pending = 0;
+    bool used = false;
+
+    void emit(std::uint32_t bit) {
+        writer.write(bit, 1);
+        for (; pending > 0; --pending) {
+            writer.write(bit ^ 1, 1);
+        }
+    }
+
+public:
+    explicit RankEncoder(std::vector<std::uint8_t>& bytes) : writer(bytes) {}
+
+    /**
+     * @brief Закодировать номер хода
+     * @param rank Номер в упорядоченном списке
+     * @param count Длина списка (больше 1)
+     */
+    void encode(int rank, int count) {
+        std::uint64_t range = high - low + 1, total = RANK_CUMULATIVE[count];
+        high = low + range * RANK_CUMULATIVE[rank + 1] / total - 1;
+        low = low + range * RANK_CUMULATIVE[rank] / total;
+        for (;;) {
+            if (high < CODE_HALF) {
+                emit(0);
+            } else if (low >= CODE_HALF) {
+                emit(1);
+                low -= CODE_HALF;
+                high -= CODE_HALF;
+            } else if (low >= CODE_QUARTER && high < 3 * CODE_QUARTER) {
+                ++pending;
+                low -= CODE_QUARTER;
+                high -= CODE_QUARTER;
+            } else {
+                break;
+            }
+            low <<= 1;
+            high = (high << 1) | 1;
+        }
+        used = true;
+    }
+
+    /// Дописать последние биты; партия без выбора ходов не занимает места
+    void finish() {
+        if (used) {
+            ++pending;
+            emit(low < CODE_QUARTER ? 0 : 1);
+        }
+        writer.finish();
+    }
+};
+
+/**
+ * @brief Декодер номеров ходов, записанных RankEncoder
+ */
+class RankDecoder {
+private:
+    BitReader reader;
+    std::uint64_t low = 0, high = CODE_TOP, value = 0;
+    bool started = false;
+
+public:
+    RankDecoder(const std::uint8_t* bytes, std::size_t length) : reader(bytes, length) {}
+
+    int decode(int count) {
+        if (!started) {
+            for (int i = 0; i < 32; ++i) {
+                value = (value << 1) | reader.readBit();
+            }
+            started = true;
+        }
+        std::uint64_t range = high - low + 1, total = RANK_CUMULATIVE[count];
+        std::uint64_t target = ((value - low + 1) * total - 1) / range;
+        int rank = static_cast<int>(std::upper_bound(RANK_CUMULATIVE.begin(), RANK_CUMULATIVE.begin() + count + 1,
+                                                     target) - RANK_CUMULATIVE.begin()) - 1;
+        high = low + range * RANK_CUMULATIVE[rank + 1] / total - 1;
+        low = low + range * RANK_CUMULATIVE[rank] / total;
+        for (;;) {
+            if (high < CODE_HALF) {
+                // оба конца в нижней половине
+            } else if (low >= CODE_HALF) {
+                low -= CODE_HALF;
+                high -= CODE_HALF;
+                value -= CODE_HALF;
+            } else if (low >= CODE_QUARTER && high < 3 * CODE_QUARTER) {
+                low -= CODE_QUARTER;
+                high -= CODE_QUARTER;
+                value -= CODE_QUARTER;
+            } else {
+                break;
+            }
+            low <<= 1;
+            high = (high << 1) | 1;
+            value = (value << 1) | reader.readBit();
+        }
+        return rank;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Закодировать партию номерами ходов в списке законных ходов
+ * @param start Начальная позиция
+ * @param moves Ходы партии
+ * @param[out] bytes Буфер, в конец которого дописывается код
+ * @throws std::invalid_argument если ход незаконен
+ *
+ * Законные ходы упорядочиваются по вероятности (взятия, уход из-под
+ * удара), и номер хода сжимается арифметическим кодером: вероятные ходы
+ * стоят 2-3 бита, вынужденные не занимают места вовсе.
+ */
+inline void encodeGame(const Board& start, const std::vector<Move>& moves, std::vector<std::uint8_t>& bytes) {
+    detail::RankEncoder encoder(bytes);
+    Board board = start;
+    MoveList legal;
+    for (Move move : moves) {
+        generateLegalMoves(board, legal);
+        detail::orderMovesForCoding(board, legal);
+        const Move* found = std::find(legal.begin(), legal.end(), move);
+        if (found == legal.end()) {
+            throw std::invalid_argument("Незаконный ход в партии: " + moveToString(move));
+        }
+        if (legal.size > 1) {
+            encoder.encode(static_cast<int>(found - legal.begin()), legal.size);
+        }
+        board.makeMove(move);
+    }
+    encoder.finish();
+}
+
+/**
+ * @brief Раскодировать партию
+ * @param start Начальная позиция
+ * @param data Код партии
+ * @param size Длина кода в байтах
+ * @param plies Число полуходов
+ * @return Ходы партии
+ * @throws std::runtime_error если код повреждён
+ */
+inline std::vector<Move> decodeGame(const Board& start, const std::uint8_t* data, std::size_t size, int plies) {
+    std::vector<Move> moves;
+    moves.reserve(plies);
+    detail::RankDecoder decoder(data, size);
+    Board board = start;
+    MoveList legal;
+    for (int ply = 0; ply < plies; ++ply) {
+        generateLegalMoves(board, legal);
+        if (legal.size == 0) {
+            throw std::runtime_error("Запись партии повреждена");
+        }
+        detail::orderMovesForCoding(board, legal);
+        Move move = legal[legal.size > 1 ? decoder.decode(legal.size) : 0];
+        moves.push_back(move);
+        board.makeMove(move);
+    }
+    return moves;
+}
+
+/**
+ * @brief Файл, отображённый в память только для чтения
+ */
+class MappedFile {
+private:
+    const std::uint8_t* data;
+    std::size_t length;
+
+public:
+    /**
+     * @brief Отобразить файл
+     * @param path Путь к файлу
+     * @throws std::runtime_error если файл не удалось открыть или отобразить
+     */
+    explicit MappedFile(const std::string& path) : data(nullptr), length(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Не удалось открыть " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Не удалось получить размер " + path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Не удалось отобразить " + path);
+            }
+            data = static_cast<const std::uint8_t*>(mapped);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data) {
+            ::munmap(const_cast<std::uint8_t*>(data), length);
+        }
+    }
+
+    const std::uint8_t* bytes() const { return data; }
+    std::size_t size() const { return length; }
+};
+
+/**
+ * @brief Описание партии в базе
+ */
+struct GameEntry {
+    PackedPosition start;       ///< Начальная позиция
+    std::uint64_t offset;       ///< Смещение кода ходов в области данных
+    std::uint16_t plies;        ///< Число полуходов
+    std::int8_t result;         ///< Исход для белых: 1, 0 или -1
+    std::uint8_t reserved;      ///< Зарезервировано (0)
+    std::uint16_t whiteRating;  ///< Рейтинг белых (0 — неизвестен)
+    std::uint16_t blackRating;  ///< Рейтинг чёрных (0 — неизвестен)
+};
+
+static_assert(sizeof(GameEntry) == 48, "Описание партии должно занимать 48 байт");
+
+/**
+ * @brief Элемент индекса позиций: ключ Zobrist и партия, в которой он встретился
+ */
+struct PositionIndexEntry {
+    std::uint64_t key;      ///< Ключ позиции
+    std::uint32_t game;     ///< Номер партии
+    std::uint16_t ply;      ///< Первый полуход партии с этой позицией
+    std::uint16_t reserved; ///< Зарезервировано (0)
+
+    bool operator<(const PositionIndexEntry& other) const {
+        return key != other.key ? key < other.key : game != other.game ? game < other.game : ply < other.ply;
+    }
+};
+
+static_assert(sizeof(PositionIndexEntry) == 16, "Элемент индекса должен занимать 16 байт");
+
+namespace detail {
+
+constexpr char GAMES_MAGIC[8] = {'C', 'H', 'G', 'A', 'M', 'E', 'S', '2'};
+constexpr char INDEX_MAGIC[8] = {'C', 'H', 'P', 'O', 'S', 'I', 'X', '1'};
+
+/// Заголовок файла: сигнатура и число элементов
+struct FileHeader {
+    char magic[8];
+    std::uint64_t count;
+};
+
+inline void writeFile(const std::string& path, const char (&magic)[8], std::uint64_t count,
+                      const void* first, std::size_t firstSize, const void* second = nullptr,
+                      std::size_t secondSize = 0) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Не удалось создать " + path);
+    }
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.count = count;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && (firstSize == 0 || std::fwrite(first, 1, firstSize, file) == firstSize)
+        && (secondSize == 0 || std::fwrite(second, 1, secondSize, file) == secondSize);
+    if (std::fclose(file) != 0 || !ok) {
+        throw std::runtime_error("Ошибка записи " + path);
+    }
+}
+
+inline std::uint64_t checkHeader(const MappedFile& file, const char (&magic)[8], std::size_t elementSize) {
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Файл базы партий обрезан");
+    }
+    std::memcpy(&header, file.bytes(), sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Неверная сигнатура файла базы партий");
+    }
+    if ((file.size() - sizeof(header)) / elementSize < header.count) {
+        throw std::runtime_error("Файл базы партий обрезан");
+    }
+    return header.count;
+}
+
+} // namespace detail
+
+/**
+ * @brief Построение базы партий
+ *
+ * Партии накапливаются в памяти и записываются двумя файлами:
+ * <база>.games — заголовок, таблица GameEntry и коды ходов;
+ * <база>.idx — отсортированный по ключу массив PositionIndexEntry
+ * (для каждой партии и позиции — только первое вхождение).
+ */
+class GameDatabaseWriter {
+private:
+    std::vector<GameEntry> games;
+    std::vector<std::uint8_t> data;
+    std::vector<PositionIndexEntry> index;
+
+public:
+    /**
+     * @brief Добавить партию
+     * @param start Начальная позиция классического варианта
+     * @param moves Ходы партии (не больше 65535)
+     * @param result Исход
+     * @param whiteRating Рейтинг белых
+     * @param blackRating Рейтинг чёрных
+     * @return Номер партии
+     * @throws std::invalid_argument если ход незаконен или партия слишком длинная
+     */
+    std::uint32_t addGame(const Board& start, const std::vector<Move>& moves, GameResult result,
+                          int whiteRating = 0, int blackRating = 0) {
+        if (moves.size() > 0xFFFF) {
+            throw std::invalid_argument("Партия длиннее 65535 полуходов");
+        }
+        std::uint32_t id = static_cast<std::uint32_t>(games.size());
+        GameEntry entry{packPosition(start), data.size(), static_cast<std::uint16_t>(moves.size()),
+                        static_cast<std::int8_t>(result == GameResult::WHITE_WIN ? 1
+                                                 : result == GameResult::BLACK_WIN ? -1 : 0),
+                        0, static_cast<std::uint16_t>(whiteRating), static_cast<std::uint16_t>(blackRating)};
+        std::size_t dataSize = data.size(), indexSize = index.size();
+        try {
+            encodeGame(start, moves, data);
+        } catch (...) {
+            data.resize(dataSize);
+            throw;
+        }
+        Board board = start;
+        for (std::size_t ply = 0; ; ++ply) {
+            index.push_back({board.getKey(), id, static_cast<std::uint16_t>(ply), 0});
+            if (ply == moves.size()) {
+                break;
+            }
+            board.makeMove(moves[ply]);
+        }
+        // Повторения внутри партии оставляют в индексе только первое вхождение
+        std::sort(index.begin() + indexSize, index.end());
+        index.erase(std::unique(index.begin() + indexSize, index.end(),
+                                [](const PositionIndexEntry& a, const PositionIndexEntry& b) {
+                                    return a.key == b.key;
+                                }),
+                    index.end());
+        games.push_back(entry);
+        return id;
+    }
+
+    /**
+     * @brief Количество добавленных партий
+     * @return Число партий
+     */
+    std::size_t size() const { return games.size(); }
+
+    /**
+     * @brief Записать базу на диск
+     * @param base Путь без расширения
+     * @throws std::runtime_error при ошибке записи
+     */
+    void write(const std::string& base) {
+        std::sort(index.begin(), index.end());
+        detail::writeFile(base + ".games", detail::GAMES_MAGIC, games.size(),
+                          games.data(), games.size() * sizeof(GameEntry), data.data(), data.size());
+        detail::writeFile(base + ".idx", detail::INDEX_MAGIC, index.size(),
+                          index.data(), index.size() * sizeof(PositionIndexEntry));
+    }
+};
+
+/**
+ * @brief База партий, отображённая в память
+ *
+ * Файлы не читаются целиком: поиск по позиции — двоичный поиск
+ * по отображённому индексу, партии раскодируются по запросу.
+ */
+class GameDatabase {
+private:
+    MappedFile gamesFile;
+    MappedFile indexFile;
+    std::size_t gameCount;
+    std::size_t indexCount;
+
+    const GameEntry* entries() const {
+        return reinterpret_cast<const GameEntry*>(gamesFile.bytes() + sizeof(detail::FileHeader));
+    }
+
+    const std::uint8_t* moveData() const {
+        return gamesFile.bytes() + sizeof(detail::FileHeader) + gameCount * sizeof(GameEntry);
+    }
+
+    std::size_t moveDataSize() const {
+        return gamesFile.size() - sizeof(detail::FileHeader) - gameCount * sizeof(GameEntry);
+    }
+
+public:
+    /**
+     * @brief Открыть базу
+     * @param base Путь без расширения
+     * @throws std::runtime_error если файлы отсутствуют или повреждены
+     */
+    explicit GameDatabase(const std::string& base)
+    : gamesFile(base + ".games"), indexFile(base + ".idx"),
+      gameCount(detail::checkHeader(gamesFile, detail::GAMES_MAGIC, sizeof(GameEntry))),
+      indexCount(detail::checkHeader(indexFile, detail::INDEX_MAGIC, sizeof(PositionIndexEntry))) {}
+
+    /**
+     * @brief Количество партий
+     * @return Число партий
+     */
+    std::size_t size() const { return gameCount; }
+
+    /**
+     * @brief Описание партии
+     * @param id Номер партии
+     * @return Запись таблицы партий
+     * @throws std::out_of_range если номера нет в базе
+     */
+    const GameEntry& entry(std::uint32_t id) const {
+        if (id >= gameCount) {
+            throw std::out_of_range("Нет партии с номером " + std::to_string(id));
+        }
+        return entries()[id];
+    }
+
+    /**
+     * @brief Ходы партии
+     * @param id Номер партии
+     * @return Ходы от начальной позиции
+     * @throws std::runtime_error если запись повреждена
+     */
+    std::vector<Move> moves(std::uint32_t id) const {
+        const GameEntry& game = entry(id);
+        if (game.offset > moveDataSize()) {
+            throw std::runtime_error("Запись партии повреждена");
+        }
+        return decodeGame(unpackPosition(game.start), moveData() + game.offset,
+                          moveDataSize() - game.offset, game.plies);
+    }
+
+    /**
+     * @brief Вхождения позиции в партии базы
+     * @param key Ключ Zobrist позиции
+     * @return Диапазон элементов индекса, упорядоченных по номеру партии
+     */
+    std::pair<const PositionIndexEntry*, const PositionIndexEntry*> positionEntries(std::uint64_t key) const {
+        const PositionIndexEntry* first =
+            reinterpret_cast<const PositionIndexEntry*>(indexFile.bytes() + sizeof(detail::FileHeader));
+        const PositionIndexEntry* last = first + indexCount;
+        const PositionIndexEntry* lower = std::lower_bound(first, last, key,
+            [](const PositionIndexEntry& entry, std::uint64_t k) { return entry.key < k; });
+        const PositionIndexEntry* upper = std::upper_bound(lower, last, key,
+            [](std::uint64_t k, const PositionIndexEntry& entry) { return k < entry.key; });
+        return {lower, upper};
+    }
+
+    /**
+     * @brief Партии, в которых встретилась позиция
+     * @param board Позиция
+     * @return Номера партий по возрастанию
+     */
+    std::vector<std::uint32_t> findGames(const Board& board) const {
+        auto range = positionEntries(board.getKey());
+        std::vector<std::uint32_t> ids;
+        ids.reserve(range.second - range.first);
+        for (const PositionIndexEntry* e = range.first; e != range.second; ++e) {
+            ids.push_back(e->game);
+        }
+        return ids;
+    }
+};
+
+}
+
+#endif
@@ -1,7 +1,33 @@
 #include "a.h"
+#include "board.h"
+#include "placement.h"
+#include "distance.h"
+#include "puzzle.h"
+#include "packed.h"
+#include "tuner.h"
+#include "gamedb.h"
+#include "explorer.h"
+#include "material.h"
+#include "analysis.h"
+#include "validate.h"
+#include "game_server.h"
+#include "broadcast.h"
+#include "analysis_service.h"
+#include "movecache.h"
+#include "render.h"
+#include "bulk_writer.h"
+#include "symmetry.h"
+#include "dedup.h"
+#include "cluster.h"
+#include "match.h"
+#include "datagen.h"
+#include "epd.h"
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <sstream>
+#include <cstring>
+#include <thread>
 
 using namespace std;
 
@@ -16,9 +42,9 @@ void testCreation() {
     Chess::Queen queen(Chess::Color::BLACK, 3, 0);
     Chess::King king(Chess::Color::WHITE, 4, 0);
     
-    cout << "Создано фигур: " << Chess::ChessPiece::getTotalCount() << endl;
-    cout << "Белых: " << Chess::ChessPiece::getWhiteCount() << endl;
-    cout << "Черных: " << Chess::ChessPiece::getBlackCount() << endl;
+    cout << "Создано фигур: " << Chess::ChessPiece::getTotalCount() << '\n';
+    cout << "Белых: " << Chess::ChessPiece::getWhiteCount() << '\n';
+    cout << "Черных: " << Chess::ChessPiece::getBlackCount() << '\n';
 }
 
 // Тест 2: Проверка движения
@@ -30,25 +56,25 @@ void testMovement() {
     // Ладья может двигаться по вертикали
     cout << "Ладья из (0,0) в (0,4): ";
     if (rook.canMoveTo(0, 4)) {
-        cout << "МОЖЕТ" << endl;
+        cout << "МОЖЕТ" << '\n';
     } else {
-        cout << "НЕ МОЖЕТ" << endl;
+        cout << "НЕ МОЖЕТ" << '\n';
     }
     
     // Ладья может двигаться по горизонтали
     cout << "Ладья из (0,0) в (4,0): ";
     if (rook.canMoveTo(4, 0)) {
-        cout << "МОЖЕТ" << endl;
+        cout << "МОЖЕТ" << '\n';
     } else {
-        cout << "НЕ МОЖЕТ" << endl;
+        cout << "НЕ МОЖЕТ" << '\n';
     }
     
     // Ладья НЕ может двигаться по диагонали
     cout << "Ладья из (0,0) в (4,4): ";
     if (rook.canMoveTo(4, 4)) {
-        cout << "МОЖЕТ" << endl;
+        cout << "МОЖЕТ" << '\n';
     } else {
-        cout << "НЕ МОЖЕТ" << endl;
+        cout << "НЕ МОЖЕТ" << '\n';
     }
     
     Chess::Knight knight(Chess::Color::WHITE, 4, 4);
@@ -56,9 +82,9 @@ void testMovement() {
     // Конь может двигаться буквой Г
     cout << "\nКонь из (4,4) в (6,5): ";
     if (knight.canMoveTo(6, 5)) {
-        cout << "МОЖЕТ" << endl;
+        cout << "МОЖЕТ" << '\n';
     } else {
-        cout << "НЕ МОЖЕТ" << endl;
+        cout << "НЕ МОЖЕТ" << '\n';
     }
 }
 
@@ -73,11 +99,11 @@ void testPolymorphism() {
     Chess::Queen queen(Chess::Color::BLACK, 3, 0);
     Chess::King king(Chess::Color::WHITE, 4, 0);
     
-    cout << rook.getType() << endl;
-    cout << bishop.getType() << endl;
-    cout << knight.getType() << endl;
-    cout << queen.getType() << endl;
-    cout << king.getType() << endl;
+    cout << rook.getType() << '\n';
+    cout << bishop.getType() << '\n';
+    cout << knight.getType() << '\n';
+    cout << queen.getType() << '\n';
+    cout << king.getType() << '\n';
 }
 
 // Тест 4: Копирование
@@ -90,13 +116,13 @@ void testCopy() {
     // Копируем
     Chess::Rook copy = original;
     
-    cout << "\n Оригинал: " << original << endl;
-    cout << "\n Копия: " << copy << endl;
+    cout << "\n Оригинал: " << original << '\n';
+    cout << "\n Копия: " << copy << '\n';
 
     copy.moveTo(3,0);
 
-    cout << "\n Оригинал: " << original << endl;
-    cout << "\n Копия: " << copy << endl;
+    cout << "\n Оригинал: " << original << '\n';
+    cout << "\n Копия: " << copy << '\n';
 }
 
 
@@ -105,7 +131,7 @@ void testStatic() {
     cout << "\n=== Тест 5: Статические счетчики ===\n";
     
     int before = Chess::ChessPiece::getTotalCount();
-    cout << "Было фигур: " << before << endl;
+    cout << "Было фигур: " << before << '\n';
     
     // Создаем фигуры в отдельном блоке
     {
@@ -114,13 +140,13 @@ void testStatic() {
         Chess::Bishop b1(Chess::Color::BLACK, 2, 0);
         
         cout << "Создали 3 фигуры. Теперь: " 
-             << Chess::ChessPiece::getTotalCount() << endl;
-        cout << "Белых: " << Chess::ChessPiece::getWhiteCount() << endl;
-        cout << "Черных: " << Chess::ChessPiece::getBlackCount() << endl;
+             << Chess::ChessPiece::getTotalCount() << '\n';
+        cout << "Белых: " << Chess::ChessPiece::getWhiteCount() << '\n';
+        cout << "Черных: " << Chess::ChessPiece::getBlackCount() << '\n';
     }
     
     // После блока фигуры уничтожаются
-    cout << "После блока снова: " << Chess::ChessPiece::getTotalCount() << endl;
+    cout << "После блока снова: " << Chess::ChessPiece::getTotalCount() << '\n';
 }
 
 // Тест 6: Ферзь (множественное наследование)
@@ -130,20 +156,20 @@ void testQueen() {
     Chess::Queen queen(Chess::Color::WHITE, 3, 3);
     
     // Проверяем как ChessPiece
-    cout << " (" << queen.getType() << ")" << endl;
+    cout << " (" << queen.getType() << ")" << '\n';
     
     cout << "Из (3,3) в (3,7) (вертикаль): ";
-    if (queen.canMoveTo(3, 7)) cout << "МОЖЕТ" << endl;
-    else cout << "НЕ МОЖЕТ" << endl;
+    if (queen.canMoveTo(3, 7)) cout << "МОЖЕТ" << '\n';
+    else cout << "НЕ МОЖЕТ" << '\n';
     
     cout << "Из (3,3) в (7,7) (диагональ): ";
-    if (queen.canMoveTo(7, 7)) cout << "МОЖЕТ" << endl;
-    else cout << "НЕ МОЖЕТ" << endl;
+    if (queen.canMoveTo(7, 7)) cout << "МОЖЕТ" << '\n';
+    else cout << "НЕ МОЖЕТ" << '\n';
     
     // Проверяем как CombinedPiece
     Chess::CombinedPiece* combine = &queen;
     cout << "\nКак комбинированная фигура: " 
-         << combine->getCombinedAbilities() << endl;
+         << combine->getCombinedAbilities() << '\n';
 }
 
 // Тест 7: Симуляция маленькой доски
@@ -162,7 +188,7 @@ void testMiniBoard() {
     chessboard.push_back(make_unique<Chess::Rook>(Chess::Color::BLACK, 7, 7));
     chessboard.push_back(make_unique<Chess::Knight>(Chess::Color::BLACK, 6, 7));
     
-    cout << "На доске " << chessboard.size() << " фигур" << endl;
+    cout << "На доске " << chessboard.size() << " фигур" << '\n';
     
     // Проверяем ходы для каждой фигуры
     int count = 0;
@@ -179,12 +205,900 @@ void testMiniBoard() {
         }
     }
     
-    cout << "Из них могут сделать ход: " << count << endl;
+    cout << "Из них могут сделать ход: " << count << '\n';
     cout << "Состояние доски корректно: " 
-         << (Chess::ChessPiece::validateBoardState() ? "ДА" : "НЕТ") << endl;
+         << (Chess::ChessPiece::validateBoardState() ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 8: Сбросы фигур (crazyhouse)
+void testCrazyhouse() {
+    cout << "\n=== Тест 8: Сбросы фигур (crazyhouse) ===\n";
+    
+    Chess::Board board(Chess::Board::Variant::CRAZYHOUSE);
+    board.putPiece(Chess::Color::WHITE, Chess::PieceKind::KING, Chess::makeSquare(4, 0));
+    board.putPiece(Chess::Color::BLACK, Chess::PieceKind::KING, Chess::makeSquare(4, 7));
+    board.putPiece(Chess::Color::WHITE, Chess::PieceKind::ROOK, Chess::makeSquare(0, 0));
+    board.putPiece(Chess::Color::BLACK, Chess::PieceKind::KNIGHT, Chess::makeSquare(0, 5));
+    
+    // Ладья берёт коня, конь попадает в карман белых
+    board.makeMove(Chess::Move::normal(Chess::makeSquare(0, 0), Chess::makeSquare(0, 5)));
+    cout << "Коней в кармане белых: "
+         << board.getPocketCount(Chess::Color::WHITE, Chess::PieceKind::KNIGHT) << '\n';
+    
+    board.setSideToMove(Chess::Color::WHITE);
+    Chess::Move drops[4 * Chess::SQUARE_COUNT];
+    cout << "Возможных сбросов: " << board.generateDrops(drops) << '\n';
+    
+    // Ключ Зобриста зависит от содержимого кармана
+    std::uint64_t before = board.getKey();
+    board.makeMove(drops[0]);
+    cout << "Ключ изменился после сброса: "
+         << (board.getKey() != before ? "ДА" : "НЕТ") << '\n';
+    
+    // Отклонённый ход не меняет позицию, включая счётчик полуходов
+    Chess::Board full = Chess::parseFen("4k3/8/8/8/8/n7/8/R3K3[NNNNNNNNNNNNNNNN] w - - 5 1");
+    const std::string fen = Chess::toFen(full);
+    const Chess::Move rejected[] = {
+        Chess::Move::normal(Chess::makeSquare(0, 0), Chess::makeSquare(0, 2)),    // Rxa3: карман переполнен
+        Chess::Move::drop(Chess::PieceKind::QUEEN, Chess::makeSquare(3, 3)),      // ферзя в кармане нет
+        Chess::Move::normal(Chess::makeSquare(1, 1), Chess::makeSquare(1, 2)),    // исходная клетка пуста
+    };
+    for (Chess::Move move : rejected) {
+        try {
+            full.makeMove(move);
+        } catch (const std::exception&) {
+        }
+        if (Chess::toFen(full) != fen) {
+            throw logic_error("Отклонённый ход изменил позицию: " + Chess::toFen(full));
+        }
+    }
+    cout << "Позиция после отклонённых ходов: " << fen << '\n';
+}
+
+// Тест 9: Задачи о неатакующих расстановках
+void testPlacement() {
+    cout << "\n=== Тест 9: Неатакующие расстановки ===\n";
+    
+    // Количества по видам: конь, слон, ладья, ферзь, король
+    Chess::PlacementSolver queens({0, 0, 0, 8, 0});
+    cout << "Восемь ферзей: " << queens.count()
+         << " (различных: " << queens.count(0, true) << ")" << '\n';
+    
+    Chess::PlacementSolver rooks({0, 0, 8, 0, 0});
+    cout << "Восемь ладей: " << rooks.count()
+         << " (различных: " << rooks.count(0, true) << ")" << '\n';
+}
+
+// Тест 10: Таблицы расстояний и обход конём
+void testKnightTour() {
+    cout << "\n=== Тест 10: Расстояния и обход доски конём ===\n";
+    
+    int a1 = Chess::makeSquare(0, 0);
+    int h8 = Chess::makeSquare(7, 7);
+    cout << "Конь от (0,0) до (7,7): " << int(Chess::distance<Chess::Knight>[a1][h8]) << " ходов" << '\n';
+    cout << "Король от (0,0) до (7,7): " << int(Chess::distance<Chess::King>[a1][h8]) << " ходов" << '\n';
+    
+    Chess::KnightTour tour;
+    cout << "Обход конём с (0,0): " << (tour.solve(a1) ? "НАЙДЕН" : "НЕ НАЙДЕН")
+         << " (узлов: " << tour.getNodeCount() << ")" << '\n';
+}
+
+// Тест 11: FEN и решение задачи
+void testPuzzle() {
+    cout << "\n=== Тест 11: FEN и решение задачи ===\n";
+    
+    Chess::Board board = Chess::parseFen("6k1/8/6K1/8/8/8/8/R7 w - - 0 1");
+    cout << "FEN: " << Chess::toFen(board) << '\n';
+    
+    Chess::MoveList moves;
+    Chess::generateLegalMoves(board, moves);
+    cout << "Законных ходов: " << moves.size << '\n';
+    
+    Chess::SearchLimits limits;
+    limits.nodes = 100000;
+    Chess::PuzzleResult result = Chess::solvePuzzle(
+        Chess::parsePuzzleLine("mate1,6k1/8/6K1/8/8/8/8/R7 w - - 0 1,a1a8"), limits);
+    cout << "Мат в один ход: " << result.found
+         << (result.status == Chess::PuzzleStatus::SOLVED ? " (РЕШЕНО)" : " (НЕ РЕШЕНО)") << '\n';
+    
+    // Мата нет: поиск мата и обычный перебор делят один лимит узлов на ход
+    limits.nodes = 2000;
+    Chess::PuzzleResult quiet = Chess::solvePuzzle(
+        Chess::parsePuzzleLine("quiet,4k3/8/8/8/8/8/8/R3K3 w - - 0 1,a1a7 e8d8 e1d2 d8c8 d2d3"), limits);
+    cout << "Без мата: " << quiet.found << ", узлов " << quiet.nodes << '\n';
+    if (quiet.status == Chess::PuzzleStatus::ERROR ||
+        quiet.nodes > limits.nodes * ((quiet.found.size() + 1) / 5)) {
+        throw logic_error("Перебор задачи превысил лимит узлов на ход");
+    }
+}
+
+// Тест 12: Упаковка позиции в 32 байта
+void testPackedPosition() {
+    cout << "\n=== Тест 12: Упаковка позиции в 32 байта ===\n";
+    
+    Chess::Board board = Chess::parseFen("rnbqkbnr/8/8/8/8/8/8/RNBQKBNR b - - 3 12");
+    Chess::PackedPosition packed = Chess::packPosition(board);
+    Chess::Board restored = Chess::unpackPosition(packed);
+    
+    cout << "Размер: " << sizeof(packed) << " байта" << '\n';
+    cout << "Восстановлено: " << Chess::toFen(restored) << '\n';
+    cout << "Ключи совпадают: " << (restored.getKey() == board.getKey() ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 13: Линейная форма оценки для настройки
+void testTuner() {
+    cout << "\n=== Тест 13: Линейная форма оценки для настройки ===\n";
+    
+    Chess::EvalParams params;
+    params.tropismWeight = 3;
+    for (int sq = 0; sq < Chess::SQUARE_COUNT; ++sq) {
+        params.pieceSquare[0][sq] = sq % 8;
+        params.pieceSquare[4][sq] = -sq / 8;
+    }
+    Chess::Board board = Chess::parseFen("r1bqk3/8/2n5/8/4N3/8/8/R2QKB2 b - - 0 1");
+    Chess::TuningSet set;
+    set.add(board, 0.5);
+    
+    int linear = static_cast<int>(set.evaluate(0, Chess::paramsToWeights(params)));
+    int direct = -Chess::evaluate(board, params);
+    cout << "Линейная оценка: " << linear << ", evaluate(): " << direct << '\n';
+    cout << "Совпадают: " << (linear == direct ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 14: Сжатая запись партии
+void testGameEncoding() {
+    cout << "\n=== Тест 14: Сжатая запись партии ===\n";
+    
+    Chess::Board board = Chess::parseFen("rnbqkbnr/8/8/8/8/8/8/RNBQKBNR w - - 0 1");
+    const Chess::Board start = board;
+    vector<Chess::Move> moves;
+    for (const char* san : {"Nc3", "Nf6", "Qd5", "Nxd5", "Nxd5", "Qxd5"}) {
+        moves.push_back(Chess::parseSan(board, san));
+        board.makeMove(moves.back());
+    }
+    vector<uint8_t> bytes;
+    Chess::encodeGame(start, moves, bytes);
+    vector<Chess::Move> decoded = Chess::decodeGame(start, bytes.data(), bytes.size(), static_cast<int>(moves.size()));
+    
+    cout << "Полуходов: " << moves.size() << ", байт: " << bytes.size() << '\n';
+    cout << "Раскодировано верно: " << (decoded == moves ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 15: Материальная сигнатура
+void testMaterialSignature() {
+    cout << "\n=== Тест 15: Материальная сигнатура ===\n";
+    
+    Chess::Board board = Chess::parseFen("4k3/8/8/3r4/8/8/8/R3K1N1 w - - 0 1");
+    Chess::MaterialSignature signature = Chess::materialSignature(board);
+    
+    cout << "Сигнатура: " << Chess::materialSignatureToString(signature) << '\n';
+    cout << "KRNvKR: " << (Chess::parseMaterialPattern("KRNvKR").matches(signature) ? "ДА" : "НЕТ") << '\n';
+    cout << "KR+vKR: " << (Chess::parseMaterialPattern("KR+vKR").matches(signature) ? "ДА" : "НЕТ") << '\n';
+    cout << "KRvKR: " << (Chess::parseMaterialPattern("KRvKR").matches(signature) ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 16: Разбор партии
+void testGameAnalysis() {
+    cout << "\n=== Тест 16: Разбор партии ===\n";
+    
+    Chess::Board board = Chess::parseFen("r3k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    const Chess::Board start = board;
+    vector<Chess::Move> moves;
+    for (const char* san : {"Kd2", "Rxa1"}) {
+        moves.push_back(Chess::parseSan(board, san));
+        board.makeMove(moves.back());
+    }
+    Chess::AnalysisOptions options;
+    options.limits.depth = 3;
+    Chess::TranspositionTable table(1);
+    vector<Chess::PlyAnalysis> analysis = Chess::analyzeGame(start, moves, options, table);
+    
+    cout << "Kd2: потеря " << analysis[0].loss << ", грубая ошибка: "
+         << (analysis[0].annotation == Chess::MoveAnnotation::BLUNDER ? "ДА" : "НЕТ") << '\n';
+    cout << "Rxa1: без замечаний: "
+         << (analysis[1].annotation == Chess::MoveAnnotation::NONE ? "ДА" : "НЕТ") << '\n';
+}
+
+// Тест 17: Проверка законности ходов партии
+void testValidateGame() {
+    cout << "\n=== Тест 17: Проверка законности ходов партии ===\n";
+    
+    const string fen = "r3k3/8/8/8/8/8/8/R3K3 w - - 0 1";
+    using Chess::Move;
+    vector<Move> legal = {Move::normal(0, 56), Move::normal(60, 52)};                    // Rxa8+ Ke7
+    vector<Move> blocked = {Move::normal(0, 7)};                                          // Ra1-h1 сквозь короля
+    vector<Move> check = {Move::normal(4, 11), Move::normal(56, 59), Move::normal(0, 8)}; // Kd2 Rd8+ Ra2
+    vector<Move> turn = {Move::normal(4, 11), Move::normal(11, 19)};                     // Kd2 Kd3
+    
+    cout << "Rxa8+ Ke7: " << (Chess::validateGame(fen, legal) == Chess::GAME_VALID ? "законно" : "ошибка") << '\n';
+    cout << "Ra1-h1 — незаконный полуход: " << Chess::validateGame(fen, blocked) << '\n';
+    cout << "Kd2 Rd8+ Ra2 — незаконный полуход: " << Chess::validateGame(fen, check) << '\n';
+    cout << "Kd2 Kd3 — незаконный полуход: " << Chess::validateGame(fen, turn) << '\n';
+    
+    // Все 65536 кодов хода в случайных позициях: isPseudoLegal совпадает с генератором
+    int positions = 0, mismatches = 0;
+    std::uint32_t seed = 777;
+    for (const char* start : {"r3k3/8/8/3q4/8/8/2B5/R3K2R[QNnbr] w - - 0 1", Chess::PAWNLESS_START_FEN}) {
+        Chess::Board board = Chess::parseFen(start);
+        for (int ply = 0; ply < 60; ++ply, ++positions) {
+            Chess::MoveList pseudo;
+            Chess::generatePseudoLegalMoves(board, pseudo);
+            std::vector<bool> generated(1 << 16);
+            for (Move move : pseudo) {
+                generated[move.raw()] = true;
+            }
+            for (std::uint32_t raw = 0; raw < (1u << 16); ++raw) {
+                Move move = Move::fromRaw(static_cast<std::uint16_t>(raw));
+                mismatches += Chess::isPseudoLegal(board, move) != generated[raw];
+            }
+            Chess::MoveList legal;
+            Chess::generateLegalMoves(board, legal);
+            if (legal.size == 0) {
+                break;
+            }
+            seed = seed * 1103515245u + 12345u;
+            board.makeMove(legal[static_cast<int>((seed >> 16) % static_cast<std::uint32_t>(legal.size))]);
+        }
+    }
+    cout << "isPseudoLegal и генератор: позиций " << positions << ", расхождений " << mismatches << '\n';
+    if (mismatches != 0) {
+        throw logic_error("isPseudoLegal расходится с generatePseudoLegalMoves");
+    }
+}
+
+// Тест 18: Менеджер партий сервера
+void testGameManager() {
+    cout << "\n=== Тест 18: Менеджер партий сервера ===\n";
+    
+    Chess::GameManager manager;
+    Chess::GameId first = manager.createGame();
+    Chess::GameId second = manager.createGame(Chess::parseFen("r3k3/8/8/8/8/8/8/R3K3 w - - 0 1"));
+    int rejected = 0;
+    manager.setMoveListener([&rejected](const Chess::MoveEvent& event, const Chess::Board&) {
+        if (event.outcome != Chess::MoveOutcome::ACCEPTED) ++rejected;
+    });
+    
+    manager.submitMove(first, Chess::Color::WHITE, Chess::Move::normal(1, 18));   // Nc3
+    manager.submitMove(first, Chess::Color::WHITE, Chess::Move::normal(6, 21));   // Nf3 — не очередь белых
+    manager.submitMove(second, Chess::Color::WHITE, Chess::Move::normal(0, 7));   // Ra1-h1 — незаконно
+    manager.submitMove(second, Chess::Color::WHITE, Chess::Move::normal(0, 56));  // Rxa8+
+    cout << "Обработано ходов: " << manager.processAll() << ", отклонено: " << rejected << '\n';
+    
+    Chess::GameSnapshot snapshot;
+    manager.snapshot(second, snapshot);
+    cout << "Партия " << second << ": " << Chess::toFen(snapshot.board) << '\n';
+    manager.removeGame(first);
+    cout << "Партий на сервере: " << manager.size() << '\n';
+    
+    // Предварительный ход чёрных пришёл раньше хода белых, но принимается после него
+    Chess::GameId premove = manager.createGame();
+    rejected = 0;
+    manager.submitMove(premove, Chess::Color::BLACK, Chess::Move::normal(57, 42));   // Nc6
+    manager.submitMove(premove, Chess::Color::WHITE, Chess::Move::normal(1, 18));    // Nc3
+    manager.processAll();
+    manager.snapshot(premove, snapshot);
+    if (rejected != 0 || snapshot.plies != 2) {
+        throw logic_error("Предварительный ход отклонён из-за порядка очередей");
+    }
+    
+    // Белые и чёрные присылают ходы из разных потоков: ни один ход не теряется
+    Chess::GameId racing = manager.createGame();
+    std::atomic<int> events(0);
+    manager.setMoveListener([&events](const Chess::MoveEvent&, const Chess::Board&) { ++events; });
+    const int perPlayer = 32;
+    auto player = [&manager, racing](Chess::Color color, int from, int to) {
+        for (int i = 0; i < perPlayer; ++i) {
+            manager.submitMove(racing, color, i % 2 ? Chess::Move::normal(to, from) : Chess::Move::normal(from, to));
+        }
+    };
+    std::thread white(player, Chess::Color::WHITE, 1, 18);
+    std::thread black(player, Chess::Color::BLACK, 57, 42);
+    for (int spin = 0; events < 2 * perPlayer && spin < 1000000; ++spin) {
+        manager.processAll();
+    }
+    white.join();
+    black.join();
+    manager.processAll();
+    cout << "Ходов из двух потоков обработано: " << events << '\n';
+    if (events != 2 * perPlayer) {
+        throw logic_error("Ходы игроков из разных потоков потеряны");
+    }
+}
+
+// Тест 19: Трансляция партии зрителям
+void testSpectators() {
+    cout << "\n=== Тест 19: Трансляция партии зрителям ===\n";
+    
+    Chess::GameManager manager;
+    Chess::SpectatorHub hub(4);
+    Chess::GameId game = manager.createGame();
+    hub.open(game, Chess::parseFen(Chess::PAWNLESS_START_FEN));
+    manager.setMoveListener([&hub](const Chess::MoveEvent& event, const Chess::Board& after) {
+        hub.publish(event, after);
+    });
+    
+    Chess::Spectator live(hub.channel(game));
+    Chess::Spectator late(hub.channel(game));
+    const Chess::Move moves[] = {
+        Chess::Move::normal(1, 18), Chess::Move::normal(57, 42),   // Nc3 Nc6
+        Chess::Move::normal(18, 1), Chess::Move::normal(42, 57),   // Nb1 Nb8
+        Chess::Move::normal(6, 21), Chess::Move::normal(62, 45),   // Nf3 Nf6
+    };
+    std::size_t seen = 0;
+    for (std::size_t i = 0; i < 6; ++i) {
+        manager.submitMove(game, i % 2 ? Chess::Color::BLACK : Chess::Color::WHITE, moves[i]);
+        manager.processAll();
+        seen += live.poll();
+    }
+    
+    Chess::MoveDelta delta = Chess::MoveDelta::unpack(Chess::MoveDelta{7, moves[0], 2, true, false, Chess::GameResult::DRAW}.pack());
+    cout << "Дельта после распаковки: #" << delta.sequence << " " << Chess::moveToString(delta.move)
+         << " взятие " << delta.captured << " шах " << delta.check << '\n';
+    cout << "Зритель в темпе: ходов " << seen << ", догонял " << live.getCatchUpCount() << " раз" << '\n';
+    cout << "Отставший зритель: применено " << late.poll() << ", догонял " << late.getCatchUpCount()
+         << " раз, номер " << late.getSequence() << '\n';
+    if (late.position().getKey() != live.position().getKey()) {
+        throw logic_error("Позиции зрителей разошлись");
+    }
+    cout << "Позиция зрителей: " << Chess::toFen(late.position()) << '\n';
+}
+
+// Тест 20: Служба анализа с объединением запросов
+void testAnalysisService() {
+    cout << "\n=== Тест 20: Служба анализа с объединением запросов ===\n";
+    
+    Chess::ThreadPool pool(1);
+    Chess::AnalysisService service(pool, 1, 16);
+    // Занимаем единственный поток, чтобы одинаковые запросы застали друг друга в очереди
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    pool.submit([gate] { gate.wait(); });
+    
+    vector<Chess::AnalysisReply> replies;
+    std::mutex repliesMutex;
+    auto collect = [&replies, &repliesMutex](const Chess::AnalysisReply& reply) {
+        std::lock_guard<std::mutex> lock(repliesMutex);
+        replies.push_back(reply);
+    };
+    Chess::AnalysisRequest request;
+    request.depth = 4;
+    request.position = Chess::packPosition(Chess::parseFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"));
+    for (std::uint32_t id = 0; id < 3; ++id) {
+        request.id = id;
+        service.submit(request, collect);
+    }
+    release.set_value();
+    service.wait();
+    request.id = 3;
+    service.submit(request, collect);
+    request.id = 4;
+    request.depth = 0;
+    service.submit(request, collect);
+    
+    for (const Chess::AnalysisReply& reply : replies) {
+        cout << "Запрос " << reply.id << ": состояние " << int(reply.status) << ", ход "
+             << Chess::moveToString(Chess::Move::fromRaw(reply.move)) << ", глубина " << int(reply.depth) << '\n';
+    }
+    Chess::AnalysisService::Stats stats = service.getStats();
+    cout << "Объединено: " << stats.coalesced << ", из кэша: " << stats.cacheHits
+         << ", переборов: " << stats.searches << '\n';
+    if (stats.searches != 1 || stats.coalesced != 2 || stats.cacheHits != 1) {
+        throw logic_error("Одинаковые запросы не объединены");
+    }
+}
+
+// Тест 21: Кэш законных ходов
+void testLegalMoveCache() {
+    cout << "\n=== Тест 21: Кэш законных ходов ===\n";
+    
+    Chess::LegalMoveCache cache(1);
+    Chess::Board board = Chess::parseFen(Chess::PAWNLESS_START_FEN);
+    int hits = 0, mismatches = 0;
+    std::uint32_t seed = 12345;
+    // Случайные партии по кругу: позиции повторяются и вытесняют друг друга
+    for (int step = 0; step < 4000; ++step) {
+        Chess::MoveList cached, fresh;
+        hits += cache.generate(board, cached);
+        Chess::generateLegalMoves(board, fresh);
+        if (cached.size != fresh.size || !std::equal(fresh.begin(), fresh.end(), cached.begin())) {
+            ++mismatches;
+        }
+        if (fresh.size == 0 || step % 40 == 39) {
+            board = Chess::parseFen(Chess::PAWNLESS_START_FEN);
+            continue;
+        }
+        seed = seed * 1103515245u + 12345u;
+        board.makeMove(fresh[static_cast<int>((seed >> 16) % static_cast<std::uint32_t>(fresh.size))]);
+    }
+    cout << "Ёмкость: " << cache.size() << " позиций, попаданий: " << hits << " из 4000, расхождений: "
+         << mismatches << '\n';
+    if (mismatches != 0 || hits == 0) {
+        throw logic_error("Кэш вернул неверный список ходов");
+    }
+    
+    Chess::GameManager manager;
+    Chess::GameId game = manager.createGame();
+    Chess::MoveList moves;
+    manager.legalMoves(game, moves);
+    cout << "Ходов в начальной позиции партии: " << moves.size << '\n';
+}
+
+// Тест 22: Текст без выделения памяти
+void testNotationText() {
+    cout << "\n=== Тест 22: Текст без выделения памяти ===\n";
+    
+    Chess::Queen queen(Chess::Color::WHITE, 3, 0);
+    Chess::Knight knight(Chess::Color::BLACK, 6, 7);
+    cout << queen.getType(Chess::Language::ENGLISH) << ": " << queen.getMoveType(Chess::Language::ENGLISH) << '\n';
+    cout << knight.getType() << " / " << knight.getType(Chess::Language::ENGLISH) << '\n';
+    cout << queen.getCombinedAbilities(Chess::Language::ENGLISH) << '\n';
+    
+    char buffer[Chess::FEN_MAX_LENGTH];
+    char* end = Chess::formatPiece(buffer, knight, Chess::Language::ENGLISH);
+    *end++ = ' ';
+    end = Chess::formatMove(end, Chess::Move::normal(1, 18));
+    *end++ = ' ';
+    end = Chess::formatMove(end, Chess::Move::drop(Chess::PieceKind::QUEEN, 28));
+    cout << std::string_view(buffer, static_cast<std::size_t>(end - buffer)) << '\n';
+    
+    const std::string fen = "r3k3/8/8/8/8/8/8/R3K3[RQnn] b - - 12 40";
+    Chess::Board board = Chess::parseFen(fen);
+    std::string_view written(buffer, static_cast<std::size_t>(Chess::formatFen(buffer, board) - buffer));
+    cout << "FEN: " << written << '\n';
+    if (written != fen) {
+        throw logic_error("formatFen записал другую позицию");
+    }
+}
+
+// Тест 23: Диаграмма доски и блочный вывод
+void testRender() {
+    cout << "\n=== Тест 23: Диаграмма доски и блочный вывод ===\n";
+    
+    Chess::Board board = Chess::parseFen("r3k3/8/8/8/8/8/8/R3K3[Qn] w - - 0 1");
+    const Chess::Move line[] = {Chess::Move::normal(0, 56), Chess::Move::normal(60, 52)};
+    Chess::RenderOptions options;
+    options.fen = true;
+    options.moves = line;
+    options.moveCount = 2;
+    
+    // Вывод в тот же дескриптор, что и cout: сначала сбрасываем поток
+    cout << flush;
+    {
+        Chess::BulkWriter writer(1, 256);
+        writer.commit(Chess::renderPosition(writer.reserve(Chess::renderedLength(options)), board, options));
+        for (int i = 0; i < 3; ++i) {
+            char* out = writer.reserve(Chess::MOVE_TEXT_MAX + 1);
+            out = Chess::formatMove(out, line[i % 2]);
+            *out++ = i == 2 ? '\n' : ' ';
+            writer.commit(out);
+        }
+    }
+    
+    char diagram[Chess::DIAGRAM_LENGTH];
+    std::size_t length = static_cast<std::size_t>(Chess::formatDiagram(diagram, board) - diagram);
+    cout << "Длина диаграммы: " << length << " байт\n";
+}
+
+// Тест 24: Симметрии позиции
+void testSymmetry() {
+    cout << "\n=== Тест 24: Симметрии позиции ===\n";
+    
+    Chess::Bitboard sample = 0x0123456789ABCDEFULL;
+    for (int symmetry = 0; symmetry < Chess::SYMMETRY_COLORS; ++symmetry) {
+        Chess::Bitboard expected = 0;
+        for (int sq = 0; sq < Chess::SQUARE_COUNT; ++sq) {
+            if (sample & Chess::squareBit(sq)) {
+                expected |= Chess::squareBit(Chess::transformSquare(sq, symmetry));
+            }
+        }
+        int back = Chess::inverseSymmetry(symmetry);
+        if (Chess::transformBitboard(sample, symmetry) != expected
+            || Chess::transformBitboard(expected, back) != sample) {
+            throw logic_error("Перестановка битов не совпадает с преобразованием клеток");
+        }
+    }
+    
+    Chess::Board board = Chess::parseFen("2k5/8/1n6/8/4Q3/8/8/6KR[Bb] b - - 3 20");
+    std::uint64_t canonical = Chess::canonicalKey(board);
+    Chess::MoveList moves;
+    Chess::generateLegalMoves(board, moves);
+    int distinct = 0;
+    for (int symmetry = 0; symmetry < Chess::SYMMETRY_COUNT; ++symmetry) {
+        Chess::Board image = Chess::transformBoard(board, symmetry);
+        Chess::MoveList imageMoves;
+        Chess::generateLegalMoves(image, imageMoves);
+        int found = 0;
+        for (Chess::Move move : moves) {
+            Chess::Move mapped = Chess::transformMove(move, symmetry);
+            found += std::find(imageMoves.begin(), imageMoves.end(), mapped) != imageMoves.end();
+        }
+        distinct += image.getKey() != board.getKey();
+        if (Chess::canonicalKey(image) != canonical || found != moves.size || imageMoves.size != moves.size) {
+            throw logic_error("Симметричная позиция не совпадает с исходной");
+        }
+    }
+    Chess::CanonicalPosition form = Chess::canonicalize(board);
+    cout << "Различных образов: " << distinct + 1 << ", канонический: "
+         << Chess::toFen(Chess::transformBoard(board, form.symmetry)) << '\n';
+    if (Chess::transformBoard(board, form.symmetry).getKey() != form.key) {
+        throw logic_error("Канонический ключ не совпадает с ключом образа");
+    }
+    
+    // Зеркальный запрос берётся из кэша службы, ход переводится обратно
+    Chess::ThreadPool pool(1);
+    Chess::AnalysisService service(pool, 1, 16);
+    vector<Chess::AnalysisReply> replies;
+    std::mutex repliesMutex;
+    auto collect = [&replies, &repliesMutex](const Chess::AnalysisReply& reply) {
+        std::lock_guard<std::mutex> lock(repliesMutex);
+        replies.push_back(reply);
+    };
+    Chess::Board rook = Chess::parseFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    Chess::AnalysisRequest request;
+    request.depth = 4;
+    request.position = Chess::packPosition(rook);
+    service.submit(request, collect);
+    service.wait();
+    request.id = 1;
+    request.position = Chess::packPosition(Chess::transformBoard(rook, Chess::SYMMETRY_MIRROR | Chess::SYMMETRY_COLORS));
+    service.submit(request, collect);
+    service.wait();
+    Chess::Move first = Chess::Move::fromRaw(replies[0].move);
+    Chess::Move second = Chess::Move::fromRaw(replies[1].move);
+    cout << "Ход: " << Chess::moveToString(first) << ", в отражённой позиции: " << Chess::moveToString(second) << '\n';
+    if (replies[1].status != Chess::AnalysisStatus::CACHED
+        || second != Chess::transformMove(first, Chess::SYMMETRY_MIRROR | Chess::SYMMETRY_COLORS)) {
+        throw logic_error("Отражённый запрос не взят из кэша");
+    }
+}
+
+// Тест 25: Фильтр повторных позиций
+void testPositionFilter() {
+    cout << "\n=== Тест 25: Фильтр повторных позиций ===\n";
+    
+    Chess::PositionFilter filter(1);
+    std::uint64_t state = 99;
+    const int count = 500000;
+    int rejected = 0;
+    for (int i = 0; i < count; ++i) {
+        rejected += !filter.insert(Chess::detail::splitMix64(state));
+    }
+    state = 99;
+    int missed = 0;
+    for (int i = 0; i < count; ++i) {
+        missed += filter.insert(Chess::detail::splitMix64(state));
+    }
+    cout << "Бит на позицию: " << filter.bytes() * 8 / count << ", ложных повторов: " << rejected
+         << ", оценка: " << static_cast<int>(filter.falsePositiveRate() * count) << ", пропущено повторов: "
+         << missed << '\n';
+    if (missed != 0 || rejected > count / 100) {
+        throw logic_error("Фильтр пропустил повтор или ошибается слишком часто");
+    }
+    
+    // Оценка доли ложных срабатываний совпадает с долей для новых ключей
+    int falsePositives = 0;
+    for (int i = 0; i < count; ++i) {
+        falsePositives += filter.contains(Chess::detail::splitMix64(state));
+    }
+    double measured = double(falsePositives) / count;
+    cout << "Ложных срабатываний на новых ключах: " << measured * 100 << "%, оценка: "
+         << filter.falsePositiveRate() * 100 << "%\n";
+    if (measured > filter.falsePositiveRate() * 1.5 || measured < filter.falsePositiveRate() / 1.5) {
+        throw logic_error("Оценка доли ложных срабатываний не совпадает с измеренной");
+    }
+    
+    // Восемь бит на позицию: ложных повторов много, но второй проход всё равно точен
+    Chess::ExactDeduplicator dedup(1);
+    const int distinct = 1000000;
+    int kept = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < distinct + 1000; ++i) {
+            std::uint64_t seed = static_cast<std::uint64_t>(i % distinct);
+            std::uint64_t key = Chess::detail::splitMix64(seed);
+            if (pass == 0) {
+                dedup.observe(key);
+            } else {
+                kept += dedup.keep(key);
+            }
+        }
+        if (pass == 0) {
+            dedup.finishFirstPass();
+        }
+    }
+    cout << "Точно хранится ключей: " << dedup.candidateCount() << ", оставлено позиций: " << kept << '\n';
+    if (kept != distinct) {
+        throw logic_error("Второй проход оставил не по одной записи каждой позиции");
+    }
+    
+    // Многократные повторы немногих позиций не раздувают точное множество
+    Chess::ExactDeduplicator repeated(1);
+    for (int i = 0; i < 2000000; ++i) {
+        std::uint64_t seed = static_cast<std::uint64_t>(i % 100);
+        repeated.observe(Chess::detail::splitMix64(seed));
+    }
+    cout << "Точно хранится ключей после 2000000 встреч 100 позиций: " << repeated.candidateCount() << '\n';
+    if (repeated.candidateCount() > 200000) {
+        throw logic_error("Повторные встречи ключа хранятся по отдельности");
+    }
+}
+
+// Тест 26: Инкрементальные карты атак
+void testAttackMaps() {
+    cout << "\n=== Тест 26: Инкрементальные карты атак ===\n";
+    
+    Chess::Board board = Chess::parseFen("r3k3/8/8/3q4/8/8/2B5/R3K2R[QNnb] w - - 0 1");
+    std::uint32_t seed = 2024;
+    int positions = 0, mismatches = 0;
+    for (int ply = 0; ply < 300; ++ply) {
+        // Карты атак сверяются с пересчётом с нуля
+        for (int sq = 0; sq < Chess::SQUARE_COUNT; ++sq) {
+            for (Chess::Color col : {Chess::Color::WHITE, Chess::Color::BLACK}) {
+                int expected = Chess::popCount(board.attackersTo(sq, board.occupied()) & board.piecesOf(col));
+                mismatches += board.attackerCount(sq, col) != expected;
+            }
+        }
+        // Законные ходы сверяются с пробными ходами на копии доски
+        Chess::MoveList pseudo, legal;
+        Chess::generatePseudoLegalMoves(board, pseudo);
+        Chess::generateLegalMoves(board, legal);
+        int tried = 0;
+        for (Chess::Move move : pseudo) {
+            Chess::Board next = board;
+            next.makeMove(move);
+            tried += !next.inCheck(board.getSideToMove());
+        }
+        mismatches += tried != legal.size;
+        ++positions;
+        if (legal.size == 0) {
+            board = Chess::parseFen("r3k3/8/8/3q4/8/8/2B5/R3K2R[QNnb] w - - 0 1");
+            continue;
+        }
+        seed = seed * 1103515245u + 12345u;
+        board.makeMove(legal[static_cast<int>((seed >> 16) % static_cast<std::uint32_t>(legal.size))]);
+    }
+    Chess::Board check = Chess::parseFen("4k3/8/8/8/1b2r3/8/3N4/R3K2B w - - 0 1");
+    Chess::CheckInfo info = Chess::computeCheckInfo(check);
+    Chess::MoveList evasions;
+    Chess::generateLegalMoves(check, evasions);
+    cout << "Позиций: " << positions << ", расхождений: " << mismatches << ", ответов на шах: " << evasions.size
+         << ", связанных фигур: " << Chess::popCount(info.pinned) << '\n';
+    if (mismatches != 0 || Chess::popCount(info.checkers) != 1 || Chess::popCount(info.pinned) != 1) {
+        throw logic_error("Карты атак или законные ходы не совпадают с пересчётом");
+    }
+}
+
+// Тест 27: Распределённый перебор с прерванными ответами
+void testClusterSearch() {
+    cout << "\n=== Тест 27: Распределённый перебор с прерванными ответами ===\n";
+    
+    // Рабочий по сценарию: ход 1 лучший на полной глубине, ход 2 на второй итерации
+    // отвечает с недоперебором — обычной оценкой, матом или как законченная партия
+    const std::string address = "/tmp/chess-cluster-test-" + std::to_string(getpid()) + ".sock";
+    int listener = Chess::listenOn(address);
+    enum { TRUNCATED, MATE, FINISHED };
+    std::atomic<int> scenario(TRUNCATED);
+    std::thread worker([listener, &scenario] {
+        int fd = accept(listener, nullptr, nullptr);
+        Chess::AnalysisRequest request;
+        while (fd >= 0 && Chess::readFully(fd, &request, sizeof(request))) {
+            Chess::AnalysisReply reply;
+            reply.id = request.id;
+            reply.nodes = 1;
+            reply.depth = request.depth;
+            reply.score = request.id == 1 ? -100 : 0;
+            reply.move = 1;
+            if (request.id == 2 && request.depth == 2) {
+                reply.depth = 1;
+                reply.score = static_cast<std::int16_t>(scenario == MATE ? 3 - Chess::MATE_SCORE : -500);
+                if (scenario == FINISHED) {
+                    reply.depth = 0;
+                    reply.move = 0;
+                    reply.score = 0;
+                }
+            }
+            Chess::writeFully(fd, &reply, sizeof(reply));
+        }
+        if (fd >= 0) close(fd);
+    });
+    
+    Chess::Board board = Chess::parseFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    Chess::MoveList legal;
+    Chess::generateLegalMoves(board, legal);
+    Chess::SearchLimits limits;
+    limits.depth = 3;
+    Chess::SearchResult truncated, mate, finished;
+    {
+        Chess::ClusterSearch cluster({address}, 2);
+        truncated = cluster.run(board, limits);
+        scenario = MATE;
+        mate = cluster.run(board, limits);
+        scenario = FINISHED;
+        finished = cluster.run(board, limits);
+    }
+    worker.join();
+    close(listener);
+    unlink(address.c_str());
+    
+    cout << "Недоперебор: глубина " << truncated.depth << ", ход " << Chess::moveToString(truncated.bestMove)
+         << "; мат: глубина " << mate.depth << ", ход " << Chess::moveToString(mate.bestMove)
+         << "; без ходов: глубина " << finished.depth << ", ход " << Chess::moveToString(finished.bestMove) << '\n';
+    if (truncated.depth != 2 || truncated.bestMove != legal[1] || mate.depth != 3 || mate.bestMove != legal[2]) {
+        throw logic_error("Итерация с недоперебором не отброшена");
+    }
+    if (finished.depth != 3 || finished.bestMove != legal[1]) {
+        throw logic_error("Ответ из позиции без ходов принят за недоперебор");
+    }
+}
+
+// Тест 28: SPRT при одностороннем счёте и дебюты из PGN
+void testSprtAndPgn() {
+    cout << "\n=== Тест 28: SPRT при одностороннем счёте и дебюты из PGN ===\n";
+    
+    Chess::Sprt allWins(0, 10), winsAndDraws(0, 10), allLosses(0, 10);
+    for (int i = 0; i < 200; ++i) {
+        allWins.addResult(1.0);
+        winsAndDraws.addResult(i % 4 == 0 ? 0.5 : 1.0);
+        allLosses.addResult(0.0);
+    }
+    cout << "LLR при +200: " << allWins.llr() << ", при +150 =50: " << winsAndDraws.llr()
+         << ", при -200: " << allLosses.llr() << '\n';
+    if (allWins.decision() != Chess::Sprt::Decision::ACCEPT_H1
+        || winsAndDraws.decision() != Chess::Sprt::Decision::ACCEPT_H1
+        || allLosses.decision() != Chess::Sprt::Decision::ACCEPT_H0) {
+        throw logic_error("SPRT не принял решение при одностороннем счёте");
+    }
+    
+    std::istringstream pgn(
+        "[Event \"Ладьи\"]\n[FEN \"r3k3/8/8/8/8/8/8/R3K3 w - - 0 1\"]\n\n"
+        "1. Kd2 {король к центру} Kd7 (1... Ke7 2. Ke3) 2. Ra2 $1 1/2-1/2\n\n"
+        "[Event \"Кони\"]\n\n1.Nc3 Nc6 2.Nf3 *\n");
+    vector<Chess::Board> openings = Chess::parsePgnOpenings(pgn);
+    for (const Chess::Board& opening : openings) {
+        cout << "Дебют: " << Chess::toFen(opening) << '\n';
+    }
+    if (openings.size() != 2 || openings[1].getSideToMove() != Chess::Color::BLACK) {
+        throw logic_error("Дебюты PGN прочитаны неверно");
+    }
+}
+
+// Тест 29: Дерево дебютов с перестановками ходов
+void testOpeningExplorer() {
+    cout << "\n=== Тест 29: Дерево дебютов с перестановками ходов ===\n";
+    
+    // Первые две партии приходят в одну позицию разным порядком ходов
+    const Chess::Board start = Chess::parseFen(Chess::PAWNLESS_START_FEN);
+    struct Sample {
+        const char* moves[3];
+        Chess::GameResult result;
+        int whiteRating, blackRating;
+    };
+    const Sample samples[] = {
+        {{"Nc3", "Nc6", "Nf3"}, Chess::GameResult::WHITE_WIN, 2000, 1800},
+        {{"Nf3", "Nc6", "Nc3"}, Chess::GameResult::BLACK_WIN, 2200, 2200},
+        {{"Nf3", "Nf6", nullptr}, Chess::GameResult::DRAW, 0, 0},
+    };
+    Chess::GameDatabaseWriter writer;
+    for (const Sample& sample : samples) {
+        Chess::Board board = start;
+        vector<Chess::Move> moves;
+        for (const char* san : sample.moves) {
+            if (!san) break;
+            moves.push_back(Chess::parseSan(board, san));
+            board.makeMove(moves.back());
+        }
+        writer.addGame(start, moves, sample.result, sample.whiteRating, sample.blackRating);
+    }
+    const std::string base = "/tmp/chess-explorer-test-" + std::to_string(getpid());
+    writer.write(base);
+    Chess::GameDatabase database(base);
+    Chess::ThreadPool pool(2);
+    Chess::OpeningExplorer explorer = Chess::OpeningExplorer::build(database, pool);
+    unlink((base + ".games").c_str());
+    unlink((base + ".idx").c_str());
+    
+    for (const Chess::OpeningExplorer::Entry& entry : explorer.moves(start)) {
+        cout << Chess::moveToSan(start, entry.move) << ": партий " << entry.node->games()
+             << ", средний рейтинг " << entry.node->averageRating << '\n';
+    }
+    Chess::Board shared = start;
+    for (const char* san : samples[0].moves) {
+        shared.makeMove(Chess::parseSan(shared, san));
+    }
+    const Chess::ExplorerNode* node = explorer.find(shared);
+    cout << "Позиций: " << explorer.size() << ", общая позиция: +" << (node ? node->whiteWins : 0)
+         << " =" << (node ? node->draws : 0) << " -" << (node ? node->blackWins : 0)
+         << ", средний рейтинг " << (node ? node->averageRating : 0) << '\n';
+    if (!node || node->whiteWins != 1 || node->draws != 0 || node->blackWins != 1 || node->averageRating != 2050) {
+        throw logic_error("Статистика переставленных партий не объединена");
+    }
+    // После Nf3 — рейтинговая партия и партия без рейтинга: средний только по известным
+    Chess::Board afterKnight = start;
+    afterKnight.makeMove(Chess::parseSan(start, "Nf3"));
+    if (explorer.find(afterKnight)->averageRating != 2200) {
+        throw logic_error("Партия без рейтинга учтена в среднем рейтинге");
+    }
+}
+
+// Тест 30: Запись и чтение шарда обучающих данных
+void testTrainingShard() {
+    cout << "\n=== Тест 30: Запись и чтение шарда обучающих данных ===\n";
+    
+    const Chess::Board start = Chess::parseFen(Chess::PAWNLESS_START_FEN);
+    vector<Chess::TrainingRecord> records;
+    for (int i = 0; i < 5; ++i) {
+        records.push_back({Chess::packPosition(start), static_cast<std::int16_t>(10 * i - 20),
+                           static_cast<std::int8_t>(i % 3 - 1), 0});
+    }
+    // Буфер на две записи: часть записей сбрасывается при заполнении, остаток — деструктором
+    const std::string path = "/tmp/chess-shard-test-" + std::to_string(getpid()) + ".bin";
+    {
+        Chess::ShardWriter shard(path, 2);
+        for (const Chess::TrainingRecord& record : records) {
+            shard.write(record);
+        }
+        if (shard.getRecordCount() != records.size()) {
+            throw logic_error("Шард насчитал не то число записей");
+        }
+    }
+    vector<Chess::TrainingRecord> loaded(records.size() + 1);
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    std::size_t count = file ? std::fread(loaded.data(), sizeof(Chess::TrainingRecord), loaded.size(), file) : 0;
+    if (file) std::fclose(file);
+    unlink(path.c_str());
+    cout << "Прочитано записей: " << count << '\n';
+    if (count != records.size()) {
+        throw logic_error("Из шарда прочитано не то число записей");
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (std::memcmp(&loaded[i], &records[i], sizeof(Chess::TrainingRecord)) != 0) {
+            throw logic_error("Запись шарда прочитана с искажением");
+        }
+    }
+    
+    // Ошибка записи видна из flush(), а деструктор её не выбрасывает
+    bool reported = false;
+    {
+        Chess::ShardWriter full("/dev/full", 2);
+        full.write(records[0]);
+        try {
+            full.flush();
+        } catch (const runtime_error& e) {
+            reported = true;
+            cout << "Ошибка на /dev/full: " << e.what() << '\n';
+        }
+        full.write(records[1]);
+    }
+    if (!reported) {
+        throw logic_error("Ошибка записи шарда не сообщена");
+    }
+}
+
+// Тест 31: Позиция EPD, не решённая до конца первой итерации
+void testEpdUnfinishedSearch() {
+    cout << "\n=== Тест 31: Позиция EPD, не решённая до конца первой итерации ===\n";
+    
+    // Верным объявлен первый законный ход — тот, что перебор возвращает без итераций
+    Chess::EpdPosition position;
+    position.id = "first";
+    position.fen = Chess::PAWNLESS_START_FEN;
+    Chess::Board board = Chess::parseFen(position.fen);
+    Chess::MoveList legal;
+    Chess::generateLegalMoves(board, legal);
+    position.bestMoves.push_back(Chess::moveToSan(board, legal[0]));
+    Chess::SearchLimits limits;
+    limits.nodes = 1;
+    Chess::EpdResult stopped = Chess::runEpdPosition(position, limits);
+    cout << "Лимит в 1 узел: ход " << stopped.move << ", глубина " << stopped.depth
+         << ", решено " << stopped.solved << '\n';
+    if (stopped.depth != 0 || stopped.solved || stopped.solveTimeMs >= 0) {
+        throw logic_error("Позиция засчитана решённой без завершённой итерации");
+    }
 }
 
 int main() {
+    // Вывод тестов не смешивается с stdio, поэтому синхронизация не нужна
+    ios::sync_with_stdio(false);
+    
     cout << "ТЕСТЫ ДЛЯ ШАХМАТНЫХ ФИГУР\n";
     cout << "=========================\n";
     
@@ -196,13 +1110,37 @@ int main() {
         testStatic();
         testQueen();
         testMiniBoard();
+        testCrazyhouse();
+        testPlacement();
+        testKnightTour();
+        testPuzzle();
+        testPackedPosition();
+        testTuner();
+        testGameEncoding();
+        testMaterialSignature();
+        testGameAnalysis();
+        testValidateGame();
+        testGameManager();
+        testSpectators();
+        testAnalysisService();
+        testLegalMoveCache();
+        testNotationText();
+        testRender();
+        testSymmetry();
+        testPositionFilter();
+        testAttackMaps();
+        testClusterSearch();
+        testSprtAndPgn();
+        testOpeningExplorer();
+        testTrainingShard();
+        testEpdUnfinishedSearch();
         
         cout << "\n=========================\n";
         cout << "ВСЕ ТЕСТЫ ПРОЙДЕНЫ УСПЕШНО!\n";
         cout << "=========================\n";
         
     } catch (const exception& e) {
-        cout << "\n!!! ОШИБКА: " << e.what() << endl;
+        cout << "\n!!! ОШИБКА: " << e.what() << '\n';
         return 1;
     }
     
@@ -0,0 +1,157 @@
+/**
+ * @file match.cpp
+ * @brief Матч между двумя конфигурациями движка с остановкой по SPRT
+ *
+ * Партии играются параллельно в пуле потоков. Каждая начальная позиция
+ * из файла (EPD или FEN, по одной в строке, либо дебюты в PGN — файл
+ * с расширением .pgn) разыгрывается дважды со сменой цвета. После каждой
+ * партии пересчитывается SPRT; матч прекращается, как только одна
+ * из гипотез принята или сыграно заданное число партий.
+ *
+ * Параметры задаются в виде ключ=значение:
+ *   a.nodes, b.nodes       — лимит узлов на ход (по умолчанию 20000)
+ *   a.depth, b.depth       — лимит глубины
+ *   a.tropism, b.tropism   — вес близости фигур к королю
+ *   games, threads, elo0, elo1, alpha, beta
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread match.cpp -o match
+ */
+#include "fen.h"
+#include "match.h"
+#include "thread_pool.h"
+
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Прочитать начальные позиции: партии PGN или первые четыре поля строки EPD или FEN
+ */
+vector<Chess::Board> loadOpenings(const string& path) {
+    ifstream input(path);
+    if (!input) {
+        throw runtime_error("Не удалось открыть " + path);
+    }
+    vector<Chess::Board> openings;
+    bool pgn = path.size() >= 4 && path.compare(path.size() - 4, 4, ".pgn") == 0;
+    if (pgn) {
+        openings = Chess::parsePgnOpenings(input);
+    }
+    string line;
+    while (!pgn && getline(input, line)) {
+        istringstream fields(line);
+        string placement, side, castling, enPassant;
+        if (line.empty() || line[0] == '#' || !(fields >> placement >> side >> castling >> enPassant)) {
+            continue;
+        }
+        openings.push_back(Chess::parseFen(placement + ' ' + side + ' ' + castling + ' ' + enPassant));
+    }
+    if (openings.empty()) {
+        throw runtime_error("Файл дебютов не содержит позиций");
+    }
+    return openings;
+}
+
+/**
+ * @brief Итог одной партии для первого участника
+ */
+struct PairedResult {
+    double scoreA;
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0] << " <дебюты.epd|дебюты.pgn> [ключ=значение ...]\n";
+        return 1;
+    }
+    map<string, string> options;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == string::npos) {
+            cerr << "Ожидался параметр вида ключ=значение: " << arg << '\n';
+            return 1;
+        }
+        options[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+    auto option = [&options](const string& key, const string& fallback) {
+        auto it = options.find(key);
+        return it == options.end() ? fallback : it->second;
+    };
+
+    try {
+        vector<Chess::Board> openings = loadOpenings(argv[1]);
+        Chess::EngineConfig engines[2];
+        for (int i = 0; i < 2; ++i) {
+            string prefix = i == 0 ? "a." : "b.";
+            engines[i].name = i == 0 ? "A" : "B";
+            engines[i].limits.nodes = stoull(option(prefix + "nodes", "20000"));
+            engines[i].limits.depth = stoi(option(prefix + "depth", to_string(Chess::MAX_PLY - 1)));
+            engines[i].eval.tropismWeight = stoi(option(prefix + "tropism", "2"));
+        }
+        long long maxGames = stoll(option("games", "1000"));
+        Chess::Sprt sprt(stod(option("elo0", "0")), stod(option("elo1", "10")),
+                         stod(option("alpha", "0.05")), stod(option("beta", "0.05")));
+        Chess::ThreadPool pool(stoul(option("threads", "0")));
+
+        const size_t window = 2 * pool.size();
+        deque<future<PairedResult>> pending;
+        long long started = 0, finished = 0;
+
+        auto collectOldest = [&]() {
+            PairedResult result = pending.front().get();
+            pending.pop_front();
+            sprt.addResult(result.scoreA);
+            ++finished;
+            if (finished % 20 == 0) {
+                cout << "Партий " << finished << ": +" << sprt.getWins() << " =" << sprt.getDraws()
+                     << " -" << sprt.getLosses() << ", LLR " << fixed << setprecision(2) << sprt.llr()
+                     << " [" << sprt.getLowerBound() << ", " << sprt.getUpperBound() << "]\n";
+            }
+        };
+
+        while (started < maxGames && sprt.decision() == Chess::Sprt::Decision::CONTINUE) {
+            const Chess::Board& opening = openings[(started / 2) % openings.size()];
+            bool aIsWhite = started % 2 == 0;
+            ++started;
+            pending.push_back(pool.submit([&opening, &engines, aIsWhite]() {
+                const Chess::EngineConfig& white = engines[aIsWhite ? 0 : 1];
+                const Chess::EngineConfig& black = engines[aIsWhite ? 1 : 0];
+                Chess::GameRecord game = Chess::playGame(opening, white, black);
+                double whiteScore = game.result == Chess::GameResult::WHITE_WIN ? 1.0
+                                  : game.result == Chess::GameResult::DRAW ? 0.5 : 0.0;
+                return PairedResult{aIsWhite ? whiteScore : 1.0 - whiteScore};
+            }));
+            if (pending.size() >= window) {
+                collectOldest();
+            }
+        }
+        while (!pending.empty()) {
+            collectOldest();
+        }
+
+        cout << "\nИтог после " << finished << " партий: +" << sprt.getWins() << " =" << sprt.getDraws()
+             << " -" << sprt.getLosses() << ", LLR " << fixed << setprecision(2) << sprt.llr() << '\n';
+        switch (sprt.decision()) {
+        case Chess::Sprt::Decision::ACCEPT_H1: cout << "SPRT: принята H1, A сильнее B\n"; break;
+        case Chess::Sprt::Decision::ACCEPT_H0: cout << "SPRT: принята H0, улучшения нет\n"; break;
+        default: cout << "SPRT: решение не принято\n"; break;
+        }
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,293 @@
+#ifndef CHESS_MATCH_H
+#define CHESS_MATCH_H
+
+#include "fen.h"
+#include "search.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Конфигурация движка-участника матча
+ */
+struct EngineConfig {
+    std::string name = "engine";  ///< Имя в отчётах
+    SearchLimits limits;          ///< Ограничения перебора на ход
+    EvalParams eval;              ///< Параметры оценки
+};
+
+/**
+ * @brief Исход партии
+ */
+enum class GameResult {
+    WHITE_WIN, /**< Победа белых */
+    DRAW,      /**< Ничья */
+    BLACK_WIN  /**< Победа чёрных */
+};
+
+/**
+ * @brief Сыгранная партия
+ */
+struct GameRecord {
+    GameResult result = GameResult::DRAW;
+    std::string reason;        ///< Причина завершения
+    std::vector<Move> moves;   ///< Ходы партии от начальной позиции
+};
+
+/**
+ * @brief Проверить, завершилась ли партия по правилам ничьей
+ * @param board Текущая позиция
+ * @param history Ключи предыдущих позиций партии
+ * @param[out] reason Причина ничьей
+ * @return true если позиция ничейная по правилу 50 ходов, троекратному
+ *         повторению или недостатку материала
+ */
+inline bool isRuleDraw(const Board& board, const std::vector<std::uint64_t>& history, std::string& reason) {
+    if (board.getHalfmoveClock() >= 100) {
+        reason = "правило 50 ходов";
+        return true;
+    }
+    if (isInsufficientMaterial(board)) {
+        reason = "недостаточно материала";
+        return true;
+    }
+    int repetitions = 0;
+    int reach = std::min<int>(board.getHalfmoveClock(), static_cast<int>(history.size()));
+    for (int back = 2; back <= reach; back += 2) {
+        if (history[history.size() - back] == board.getKey() && ++repetitions == 2) {
+            reason = "троекратное повторение";
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Сыграть партию между двумя конфигурациями
+ * @param start Начальная позиция
+ * @param white Конфигурация белых
+ * @param black Конфигурация чёрных
+ * @param maxPlies Предел длины партии; после него присуждается ничья
+ * @return Записанная партия с исходом
+ */
+inline GameRecord playGame(const Board& start, const EngineConfig& white, const EngineConfig& black,
+                           int maxPlies = 400) {
+    GameRecord game;
+    Board board = start;
+    std::vector<std::uint64_t> history;
+    for (int ply = 0; ; ++ply) {
+        MoveList legal;
+        generateLegalMoves(board, legal);
+        if (legal.size == 0) {
+            if (board.inCheck(board.getSideToMove())) {
+                game.result = board.getSideToMove() == Color::WHITE ? GameResult::BLACK_WIN
+                                                                    : GameResult::WHITE_WIN;
+                game.reason = "мат";
+            } else {
+                game.result = GameResult::DRAW;
+                game.reason = "пат";
+            }
+            return game;
+        }
+        if (isRuleDraw(board, history, game.reason)) {
+            game.result = GameResult::DRAW;
+            return game;
+        }
+        if (ply >= maxPlies) {
+            game.result = GameResult::DRAW;
+            game.reason = "предел длины партии";
+            return game;
+        }
+        const EngineConfig& engine = board.getSideToMove() == Color::WHITE ? white : black;
+        Search search(engine.limits, engine.eval);
+        search.setHistory(history);
+        Move move = search.run(board).bestMove;
+        history.push_back(board.getKey());
+        board.makeMove(move);
+        game.moves.push_back(move);
+    }
+}
+
+/**
+ * @brief Прочитать дебюты из PGN
+ * @param in Поток с партиями в формате PGN
+ * @return Позиции после последнего хода каждой партии
+ * @throws std::invalid_argument если ход или тег FEN некорректны
+ *
+ * Партия начинается с позиции тега FEN, а без него — с расстановки без
+ * пешек. Ходы записываются в SAN (parseSan); комментарии, варианты,
+ * номера ходов и NAG пропускаются, партия заканчивается результатом
+ * или тегами следующей партии.
+ */
+inline std::vector<Board> parsePgnOpenings(std::istream& in) {
+    std::vector<Board> openings;
+    Board board = parseFen(PAWNLESS_START_FEN);
+    bool started = false;      // у текущей партии уже есть теги или ходы
+    bool hasMoves = false;
+    auto finishGame = [&]() {
+        if (started) {
+            openings.push_back(board);
+        }
+        board = parseFen(PAWNLESS_START_FEN);
+        started = hasMoves = false;
+    };
+    auto skipUntil = [&in](char close) {
+        int depth = 1;
+        for (char c; depth > 0 && in.get(c); ) {
+            if (c == close) --depth;
+            else if (close == ')' && c == '(') ++depth;
+        }
+    };
+
+    for (char c; in.get(c); ) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            continue;
+        }
+        if (c == '[') {
+            if (hasMoves) {
+                finishGame();
+            }
+            std::string tag;
+            std::getline(in, tag, ']');
+            std::size_t quote = tag.find('"');
+            if (tag.compare(0, 4, "FEN ") == 0 && quote != std::string::npos) {
+                board = parseFen(tag.substr(quote + 1, tag.rfind('"') - quote - 1));
+            }
+            started = true;
+            continue;
+        }
+        if (c == '{') { skipUntil('}'); continue; }
+        if (c == '(') { skipUntil(')'); continue; }
+        if (c == ';') { in.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); continue; }
+
+        std::string token(1, c);
+        while (in.get(c) && !std::isspace(static_cast<unsigned char>(c)) && std::string("[{(;").find(c) == std::string::npos) {
+            token += c;
+        }
+        if (in && !std::isspace(static_cast<unsigned char>(c))) {
+            in.unget();
+        }
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            finishGame();
+            continue;
+        }
+        if (token[0] == '$') {
+            continue;
+        }
+        // Номер хода может быть слит с ходом: "12.Nf3", "12...Nf6"
+        std::size_t start = token.find_first_not_of("0123456789.");
+        if (start == std::string::npos) {
+            continue;
+        }
+        std::string san = token.substr(start);
+        try {
+            board.makeMove(parseSan(board, san));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Дебют " + std::to_string(openings.size() + 1) + ": " + e.what());
+        }
+        started = hasMoves = true;
+    }
+    finishGame();
+    return openings;
+}
+
+/**
+ * @brief Последовательный тест отношения правдоподобия (SPRT) для матча
+ *
+ * Проверяет гипотезу H1 (разница в силе равна elo1) против H0 (elo0)
+ * по счёту побед, ничьих и поражений первого участника. Используется
+ * обобщённое нормальное приближение логарифма отношения правдоподобия
+ * (GSPRT) для логистической модели Эло.
+ */
+class Sprt {
+private:
+    double elo0, elo1;
+    double lowerBound, upperBound;
+    long long wins, draws, losses;
+
+    static double expectedScore(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+
+public:
+    /**
+     * @brief Итог теста
+     */
+    enum class Decision {
+        CONTINUE, /**< Данных недостаточно */
+        ACCEPT_H0,/**< Улучшения нет (не больше elo0) */
+        ACCEPT_H1 /**< Улучшение подтверждено (не меньше elo1) */
+    };
+
+    /**
+     * @brief Конструктор теста
+     * @param eloNull Разница Эло по гипотезе H0
+     * @param eloAlt Разница Эло по гипотезе H1
+     * @param alpha Вероятность ошибки первого рода
+     * @param beta Вероятность ошибки второго рода
+     */
+    Sprt(double eloNull, double eloAlt, double alpha = 0.05, double beta = 0.05)
+    : elo0(eloNull), elo1(eloAlt),
+      lowerBound(std::log(beta / (1 - alpha))), upperBound(std::log((1 - beta) / alpha)),
+      wins(0), draws(0), losses(0) {}
+
+    /**
+     * @brief Учесть партию с точки зрения первого участника
+     * @param score 1 — победа, 0.5 — ничья, 0 — поражение
+     */
+    void addResult(double score) {
+        if (score > 0.75) ++wins;
+        else if (score < 0.25) ++losses;
+        else ++draws;
+    }
+
+    /**
+     * @brief Логарифм отношения правдоподобия по текущему счёту
+     * @return LLR (0, пока не сыграно ни одной партии)
+     *
+     * К числу побед, ничьих и поражений добавляется по 0,5, иначе при
+     * одностороннем счёте (например, 200-0) дисперсия равна нулю.
+     */
+    double llr() const {
+        if (wins + draws + losses == 0) {
+            return 0;
+        }
+        double n = static_cast<double>(wins + draws + losses) + 1.5;
+        double w = (wins + 0.5) / n, d = (draws + 0.5) / n;
+        double score = w + d / 2;
+        double variance = (w + d / 4 - score * score) / n;
+        double s0 = expectedScore(elo0), s1 = expectedScore(elo1);
+        return (s1 - s0) * (2 * score - s0 - s1) / (2 * variance);
+    }
+
+    /**
+     * @brief Решение теста по текущему счёту
+     * @return CONTINUE, пока LLR между границами
+     */
+    Decision decision() const {
+        double value = llr();
+        if (value >= upperBound) return Decision::ACCEPT_H1;
+        if (value <= lowerBound) return Decision::ACCEPT_H0;
+        return Decision::CONTINUE;
+    }
+
+    double getLowerBound() const { return lowerBound; }
+    double getUpperBound() const { return upperBound; }
+    long long getWins() const { return wins; }
+    long long getDraws() const { return draws; }
+    long long getLosses() const { return losses; }
+};
+
+}
+
+#endif
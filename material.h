@@ -0,0 +1,337 @@
+#ifndef CHESS_MATERIAL_H
+#define CHESS_MATERIAL_H
+
+#include "gamedb.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Материальная сигнатура: число коней, слонов, ладей и ферзей каждой стороны
+ *
+ * По 4 бита на пару (цвет, вид): поле colorIndex * 4 + вид. Короли
+ * не учитываются; количества больше 15 записываются как 15.
+ */
+using MaterialSignature = std::uint32_t;
+
+constexpr int MATERIAL_FIELD_COUNT = 2 * 4;  ///< Количество полей сигнатуры
+constexpr int MATERIAL_FIELD_LIMIT = 15;     ///< Наибольшее значение поля
+
+/**
+ * @brief Значение поля сигнатуры
+ * @param signature Сигнатура
+ * @param col Цвет
+ * @param kind Вид фигуры (кроме короля)
+ * @return Количество фигур
+ */
+constexpr int materialCount(MaterialSignature signature, Color col, PieceKind kind) {
+    return static_cast<int>((signature >> (4 * (colorIndex(col) * 4 + static_cast<int>(kind)))) & 15);
+}
+
+/**
+ * @brief Материальная сигнатура позиции
+ * @param board Позиция
+ * @return Сигнатура фигур на доске
+ */
+inline MaterialSignature materialSignature(const Board& board) {
+    MaterialSignature signature = 0;
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        for (int k = 0; k < 4; ++k) {
+            int count = std::min(popCount(board.piecesOf(col, static_cast<PieceKind>(k))), MATERIAL_FIELD_LIMIT);
+            signature |= MaterialSignature(count) << (4 * (colorIndex(col) * 4 + k));
+        }
+    }
+    return signature;
+}
+
+/**
+ * @brief Записать сигнатуру в виде "KRNvKR"
+ * @param signature Сигнатура
+ * @return Фигуры белых и чёрных от ферзя к коню, разделённые 'v'
+ */
+inline std::string materialSignatureToString(MaterialSignature signature) {
+    std::string text;
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        text += col == Color::WHITE ? "K" : "vK";
+        for (int k = 3; k >= 0; --k) {
+            text.append(materialCount(signature, col, static_cast<PieceKind>(k)),
+                        pieceLetter(static_cast<PieceKind>(k), Color::WHITE));
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Шаблон материала для поиска: границы количества фигур каждого поля
+ */
+struct MaterialPattern {
+    int minCount[MATERIAL_FIELD_COUNT] = {};
+    int maxCount[MATERIAL_FIELD_COUNT] = {};
+
+    /**
+     * @brief Проверить сигнатуру
+     * @param signature Сигнатура позиции
+     * @return true если каждое поле в границах шаблона
+     */
+    bool matches(MaterialSignature signature) const {
+        for (int f = 0; f < MATERIAL_FIELD_COUNT; ++f) {
+            int count = static_cast<int>((signature >> (4 * f)) & 15);
+            if (count < minCount[f] || count > maxCount[f]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Разобрать шаблон материала
+ * @param text Запись вида "KRvKR" (точный материал) или "KR+vK+" — '+' в конце
+ *             стороны означает «эти фигуры и, возможно, ещё какие-то»
+ * @return Шаблон
+ * @throws std::invalid_argument если запись некорректна
+ */
+inline MaterialPattern parseMaterialPattern(const std::string& text) {
+    std::size_t separator = text.find('v');
+    if (separator == std::string::npos || text.find('v', separator + 1) != std::string::npos) {
+        throw std::invalid_argument("Шаблон материала должен иметь вид KRvKR: " + text);
+    }
+    MaterialPattern pattern;
+    std::string sides[2] = {text.substr(0, separator), text.substr(separator + 1)};
+    for (int c = 0; c < 2; ++c) {
+        std::string side = sides[c];
+        bool open = !side.empty() && side.back() == '+';
+        if (open) {
+            side.pop_back();
+        }
+        if (side.empty() || side[0] != 'K') {
+            throw std::invalid_argument("Сторона шаблона должна начинаться с короля: " + text);
+        }
+        for (std::size_t i = 1; i < side.size(); ++i) {
+            PieceKind kind;
+            if (!parsePieceLetter(side[i], kind) || kind == PieceKind::KING) {
+                throw std::invalid_argument("Неизвестная фигура в шаблоне: " + text);
+            }
+            ++pattern.minCount[c * 4 + static_cast<int>(kind)];
+        }
+        for (int k = 0; k < 4; ++k) {
+            pattern.maxCount[c * 4 + k] = open ? MATERIAL_FIELD_LIMIT : pattern.minCount[c * 4 + k];
+        }
+    }
+    return pattern;
+}
+
+/**
+ * @brief Вхождение сигнатуры в партию
+ */
+struct MaterialPosting {
+    std::uint32_t game;     ///< Номер партии
+    std::uint16_t ply;      ///< Первый полуход с этой сигнатурой
+    std::uint16_t reserved; ///< Зарезервировано (0)
+};
+
+/**
+ * @brief Элемент каталога индекса: сигнатура и её список вхождений
+ */
+struct MaterialDirectoryEntry {
+    MaterialSignature signature; ///< Сигнатура
+    std::uint32_t count;         ///< Длина списка вхождений
+    std::uint64_t offset;        ///< Номер первого вхождения в массиве списков
+};
+
+static_assert(sizeof(MaterialPosting) == 8, "Вхождение должно занимать 8 байт");
+static_assert(sizeof(MaterialDirectoryEntry) == 16, "Элемент каталога должен занимать 16 байт");
+
+namespace detail {
+
+constexpr char MATERIAL_MAGIC[8] = {'C', 'H', 'M', 'A', 'T', 'I', 'X', '1'};
+
+} // namespace detail
+
+/**
+ * @brief Построить индекс материала по базе партий
+ * @param database База партий
+ * @param path Путь к файлу индекса (обычно <база>.mat)
+ * @param pool Пул потоков: партии раскодируются параллельно частями
+ * @throws std::runtime_error при ошибке записи или повреждённой базе
+ *
+ * Файл: заголовок (число сигнатур), каталог MaterialDirectoryEntry
+ * по возрастанию сигнатур, затем списки вхождений подряд; каждый список
+ * упорядочен по номеру партии и содержит партию не более одного раза.
+ */
+inline void writeMaterialIndex(const GameDatabase& database, const std::string& path, ThreadPool& pool) {
+    using Item = std::pair<MaterialSignature, MaterialPosting>;
+    std::size_t parts = pool.size();
+    std::size_t chunk = (database.size() + parts - 1) / parts;
+    std::vector<std::future<std::vector<Item>>> futures;
+    for (std::size_t p = 0; p * chunk < database.size(); ++p) {
+        futures.push_back(pool.submit([&database, p, chunk]() {
+            std::vector<Item> items;
+            std::size_t end = std::min(database.size(), (p + 1) * chunk);
+            for (std::size_t id = p * chunk; id < end; ++id) {
+                std::uint32_t game = static_cast<std::uint32_t>(id);
+                Board board = unpackPosition(database.entry(game).start);
+                std::vector<Move> moves = database.moves(game);
+                std::size_t first = items.size();
+                // Материал в классическом варианте только убывает, поэтому
+                // сменившаяся сигнатура больше не встретится в этой партии
+                for (std::size_t ply = 0; ; ++ply) {
+                    MaterialSignature signature = materialSignature(board);
+                    if (items.size() == first || items.back().first != signature) {
+                        items.push_back({signature, {game, static_cast<std::uint16_t>(ply), 0}});
+                    }
+                    if (ply == moves.size()) {
+                        break;
+                    }
+                    board.makeMove(moves[ply]);
+                }
+            }
+            return items;
+        }));
+    }
+    std::vector<Item> all;
+    for (auto& future : futures) {
+        std::vector<Item> items = future.get();
+        all.insert(all.end(), items.begin(), items.end());
+    }
+    std::stable_sort(all.begin(), all.end(), [](const Item& a, const Item& b) { return a.first < b.first; });
+
+    std::vector<MaterialDirectoryEntry> directory;
+    std::vector<MaterialPosting> postings;
+    postings.reserve(all.size());
+    for (const Item& item : all) {
+        if (directory.empty() || directory.back().signature != item.first) {
+            directory.push_back({item.first, 0, postings.size()});
+        }
+        ++directory.back().count;
+        postings.push_back(item.second);
+    }
+    detail::writeFile(path, detail::MATERIAL_MAGIC, directory.size(),
+                      directory.data(), directory.size() * sizeof(MaterialDirectoryEntry),
+                      postings.data(), postings.size() * sizeof(MaterialPosting));
+}
+
+/**
+ * @brief Индекс материала, отображённый в память
+ */
+class MaterialIndex {
+private:
+    MappedFile file;
+    std::size_t directorySize;
+    std::size_t postingCount;
+
+    const MaterialDirectoryEntry* directory() const {
+        return reinterpret_cast<const MaterialDirectoryEntry*>(file.bytes() + sizeof(detail::FileHeader));
+    }
+
+    const MaterialPosting* postings() const {
+        return reinterpret_cast<const MaterialPosting*>(directory() + directorySize);
+    }
+
+public:
+    /**
+     * @brief Открыть индекс
+     * @param path Путь к файлу индекса
+     * @throws std::runtime_error если файл отсутствует или повреждён
+     */
+    explicit MaterialIndex(const std::string& path)
+    : file(path), directorySize(detail::checkHeader(file, detail::MATERIAL_MAGIC, sizeof(MaterialDirectoryEntry))),
+      postingCount((file.size() - sizeof(detail::FileHeader) - directorySize * sizeof(MaterialDirectoryEntry))
+                   / sizeof(MaterialPosting)) {
+        for (std::size_t i = 0; i < directorySize; ++i) {
+            if (directory()[i].offset + directory()[i].count > postingCount) {
+                throw std::runtime_error("Индекс материала повреждён");
+            }
+        }
+    }
+
+    /**
+     * @brief Количество различных сигнатур
+     * @return Размер каталога
+     */
+    std::size_t signatureCount() const { return directorySize; }
+
+    /**
+     * @brief Вхождения одной сигнатуры
+     * @param signature Сигнатура
+     * @return Диапазон вхождений, упорядоченных по номеру партии (пустой, если сигнатуры нет)
+     */
+    std::pair<const MaterialPosting*, const MaterialPosting*> postingsOf(MaterialSignature signature) const {
+        const MaterialDirectoryEntry* first = directory();
+        const MaterialDirectoryEntry* last = first + directorySize;
+        const MaterialDirectoryEntry* found = std::lower_bound(first, last, signature,
+            [](const MaterialDirectoryEntry& entry, MaterialSignature s) { return entry.signature < s; });
+        if (found == last || found->signature != signature) {
+            return {nullptr, nullptr};
+        }
+        return {postings() + found->offset, postings() + found->offset + found->count};
+    }
+
+    /**
+     * @brief Партии, в которых встретился материал по шаблону
+     * @param pattern Шаблон материала
+     * @param pool Пул потоков для параллельного просмотра списков вхождений
+     * @return Номера партий по возрастанию без повторов
+     *
+     * Подходящие сигнатуры отбираются по каталогу, затем их списки
+     * делятся между потоками примерно поровну по числу вхождений;
+     * частичные результаты сливаются.
+     */
+    std::vector<std::uint32_t> findGames(const MaterialPattern& pattern, ThreadPool& pool) const {
+        std::vector<const MaterialDirectoryEntry*> lists;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < directorySize; ++i) {
+            if (pattern.matches(directory()[i].signature)) {
+                lists.push_back(directory() + i);
+                total += directory()[i].count;
+            }
+        }
+        std::size_t share = total / pool.size() + 1;
+        std::vector<std::future<std::vector<std::uint32_t>>> futures;
+        for (std::size_t begin = 0; begin < lists.size(); ) {
+            std::size_t end = begin, size = 0;
+            while (end < lists.size() && (size < share || end == begin)) {
+                size += lists[end++]->count;
+            }
+            futures.push_back(pool.submit([this, &lists, begin, end]() {
+                std::vector<std::uint32_t> ids;
+                for (std::size_t l = begin; l < end; ++l) {
+                    const MaterialPosting* posting = postings() + lists[l]->offset;
+                    std::size_t middle = ids.size();
+                    for (std::uint32_t i = 0; i < lists[l]->count; ++i) {
+                        ids.push_back(posting[i].game);
+                    }
+                    std::inplace_merge(ids.begin(), ids.begin() + middle, ids.end());
+                }
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+                return ids;
+            }));
+            begin = end;
+        }
+        std::vector<std::uint32_t> result;
+        for (auto& future : futures) {
+            std::vector<std::uint32_t> ids = future.get();
+            std::size_t middle = result.size();
+            result.insert(result.end(), ids.begin(), ids.end());
+            std::inplace_merge(result.begin(), result.begin() + middle, result.end());
+        }
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef CHESS_MOVECACHE_H
+#define CHESS_MOVECACHE_H
+
+#include "movegen.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Кэш списков законных ходов по ключу Зобриста
+ *
+ * Рассчитан на серверы и интерактивные клиенты, которые много раз
+ * запрашивают ходы одной и той же позиции. Таблица разбита на корзины
+ * по четыре записи; вытеснение внутри корзины — алгоритм «часы»
+ * (приближение LRU): чтение отмечает запись, стрелка пропускает отмеченные
+ * записи, снимая отметку. Чтение идёт без блокировок: запись защищена
+ * счётчиком версии (seqlock), и при одновременной перезаписи чтение
+ * считается промахом. Записи сериализуются мьютексами шардов.
+ *
+ * Ключ должен однозначно определять законные ходы: это так для ключа
+ * Board::getKey(), который учитывает фигуры, карманы и очередь хода.
+ * Позиции, где ходов больше CAPACITY_MOVES, не кэшируются.
+ */
+class LegalMoveCache {
+public:
+    static constexpr int WAYS = 4;                ///< Записей в корзине
+    static constexpr int MOVE_WORDS = 30;         ///< 64-битных слов под ходы в записи
+    static constexpr int CAPACITY_MOVES = 4 * MOVE_WORDS; ///< Наибольшее число ходов в записи
+    static constexpr std::size_t SHARD_COUNT = 64; ///< Мьютексов записи
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint32_t> sequence{0};   // 0 — запись пуста, нечётное — идёт запись
+        std::atomic<std::uint16_t> count{0};
+        std::atomic<std::uint8_t> referenced{0};
+        std::atomic<std::uint64_t> key{0};
+        std::atomic<std::uint64_t> moves[MOVE_WORDS];
+    };
+
+    static_assert(sizeof(Slot) == 256, "Запись кэша ходов должна занимать 256 байт");
+
+    std::unique_ptr<Slot[]> slots;
+    std::vector<std::uint8_t> hands;   // стрелка часов каждой корзины, под мьютексом шарда
+    std::size_t bucketMask;
+    std::unique_ptr<std::mutex[]> shardMutexes;
+
+    std::size_t bucketOf(std::uint64_t key) const { return static_cast<std::size_t>(key) & bucketMask; }
+
+public:
+    /**
+     * @brief Конструктор кэша
+     * @param megabytes Размер в мегабайтах (округляется вниз до степени двойки корзин)
+     */
+    explicit LegalMoveCache(std::size_t megabytes = 16) : shardMutexes(new std::mutex[SHARD_COUNT]) {
+        std::size_t buckets = 1;
+        while (buckets * 2 * WAYS * sizeof(Slot) <= (megabytes << 20)) {
+            buckets *= 2;
+        }
+        slots.reset(new Slot[buckets * WAYS]);
+        hands.assign(buckets, 0);
+        bucketMask = buckets - 1;
+    }
+
+    LegalMoveCache(const LegalMoveCache&) = delete;
+    LegalMoveCache& operator=(const LegalMoveCache&) = delete;
+
+    /**
+     * @brief Найти ходы позиции
+     * @param key Ключ позиции
+     * @param[out] list Законные ходы (в порядке генератора)
+     * @return true если позиция есть в кэше
+     */
+    bool probe(std::uint64_t key, MoveList& list) const {
+        Slot* bucket = &slots[bucketOf(key) * WAYS];
+        for (int way = 0; way < WAYS; ++way) {
+            Slot& slot = bucket[way];
+            std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before == 0 || (before & 1) || slot.key.load(std::memory_order_relaxed) != key) {
+                continue;
+            }
+            int count = slot.count.load(std::memory_order_relaxed);
+            for (int w = 0; w * 4 < count; ++w) {
+                std::uint64_t word = slot.moves[w].load(std::memory_order_relaxed);
+                for (int i = 0; i < 4 && 4 * w + i < count; ++i) {
+                    list.moves[4 * w + i] = Move::fromRaw(static_cast<std::uint16_t>(word >> (16 * i)));
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                return false;
+            }
+            list.size = count;
+            if (!slot.referenced.load(std::memory_order_relaxed)) {
+                slot.referenced.store(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Сохранить ходы позиции
+     * @param key Ключ позиции
+     * @param list Законные ходы
+     */
+    void store(std::uint64_t key, const MoveList& list) {
+        if (list.size > CAPACITY_MOVES) {
+            return;
+        }
+        std::size_t index = bucketOf(key);
+        Slot* bucket = &slots[index * WAYS];
+        std::lock_guard<std::mutex> lock(shardMutexes[index % SHARD_COUNT]);
+        Slot* victim = nullptr;
+        for (int way = 0; way < WAYS && !victim; ++way) {
+            if (bucket[way].key.load(std::memory_order_relaxed) == key) {
+                victim = &bucket[way];
+            }
+        }
+        // Стрелка делает не больше двух оборотов: после первого все отметки сняты
+        for (int step = 0; !victim; ++step) {
+            Slot& slot = bucket[hands[index]];
+            hands[index] = static_cast<std::uint8_t>((hands[index] + 1) % WAYS);
+            if (slot.referenced.load(std::memory_order_relaxed) && step < WAYS) {
+                slot.referenced.store(0, std::memory_order_relaxed);
+            } else {
+                victim = &slot;
+            }
+        }
+
+        std::uint32_t sequence = victim->sequence.load(std::memory_order_relaxed);
+        victim->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        victim->key.store(key, std::memory_order_relaxed);
+        victim->count.store(static_cast<std::uint16_t>(list.size), std::memory_order_relaxed);
+        for (int w = 0; w * 4 < list.size; ++w) {
+            std::uint64_t word = 0;
+            for (int i = 0; i < 4 && 4 * w + i < list.size; ++i) {
+                word |= std::uint64_t(list.moves[4 * w + i].raw()) << (16 * i);
+            }
+            victim->moves[w].store(word, std::memory_order_relaxed);
+        }
+        victim->referenced.store(0, std::memory_order_relaxed);
+        victim->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Законные ходы позиции: из кэша или генератором с сохранением
+     * @param board Позиция
+     * @param[out] list Законные ходы
+     * @return true если список взят из кэша
+     */
+    bool generate(const Board& board, MoveList& list) {
+        if (probe(board.getKey(), list)) {
+            return true;
+        }
+        list.size = 0;
+        generateLegalMoves(board, list);
+        store(board.getKey(), list);
+        return false;
+    }
+
+    /**
+     * @brief Очистить кэш (не вызывать одновременно с другими методами)
+     */
+    void clear() {
+        for (std::size_t i = 0; i <= bucketMask; ++i) {
+            hands[i] = 0;
+            for (int way = 0; way < WAYS; ++way) {
+                Slot& slot = slots[i * WAYS + way];
+                slot.sequence.store(0, std::memory_order_relaxed);
+                slot.key.store(0, std::memory_order_relaxed);
+                slot.count.store(0, std::memory_order_relaxed);
+                slot.referenced.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Количество записей
+     * @return Ёмкость кэша в позициях
+     */
+    std::size_t size() const { return (bucketMask + 1) * WAYS; }
+};
+
+}
+
+#endif
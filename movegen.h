@@ -0,0 +1,454 @@
+#ifndef CHESS_MOVEGEN_H
+#define CHESS_MOVEGEN_H
+
+#include "board.h"
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+constexpr int MAX_MOVES = 512; ///< Верхняя граница числа ходов в позиции (со сбросами)
+
+/**
+ * @brief Список ходов фиксированного размера
+ *
+ * Не выделяет динамическую память, поэтому подходит для горячих циклов перебора.
+ */
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int size = 0;
+
+    void add(Move move) { moves[size++] = move; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + size; }
+    Move& operator[](int i) { return moves[i]; }
+    Move operator[](int i) const { return moves[i]; }
+};
+
+/**
+ * @brief Сгенерировать псевдолегальные ходы стороны, делающей ход
+ * @param board Позиция
+ * @param[out] list Список, в который добавляются ходы
+ *
+ * Ходы могут оставлять своего короля под шахом.
+ */
+inline void generatePseudoLegalMoves(const Board& board, MoveList& list) {
+    Color side = board.getSideToMove();
+    Bitboard own = board.piecesOf(side);
+    Bitboard occupied = board.occupied();
+    for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+        PieceKind kind = static_cast<PieceKind>(k);
+        Bitboard from = board.piecesOf(side, kind);
+        while (from) {
+            int sq = popLowestSquare(from);
+            Bitboard targets = pieceAttacks(kind, sq, occupied) & ~own;
+            while (targets) {
+                list.add(Move::normal(sq, popLowestSquare(targets)));
+            }
+        }
+    }
+    if (board.getVariant() == Board::Variant::CRAZYHOUSE) {
+        list.size += board.generateDrops(list.moves + list.size);
+    }
+}
+
+/**
+ * @brief Проверить, что ход псевдолегален в позиции
+ * @param board Позиция
+ * @param move Произвольный ход (например, полученный извне)
+ * @return true если ход есть среди generatePseudoLegalMoves
+ *
+ * Проверяет один ход без построения списка: фигуру стороны, делающей ход,
+ * на исходной клетке, её атаки с учётом блокирующих фигур и сбросы из кармана.
+ */
+inline bool isPseudoLegal(const Board& board, Move move) {
+    Color side = board.getSideToMove();
+    Bitboard target = squareBit(move.to());
+    if (move.isDrop()) {
+        PieceKind kind = move.dropKind();
+        return board.getVariant() == Board::Variant::CRAZYHOUSE && move.from() == 0
+            && static_cast<int>(kind) < static_cast<int>(PieceKind::KING)
+            && board.getPocketCount(side, kind) > 0
+            && (board.dropTargets(kind) & target) != 0;
+    }
+    int from = move.from();
+    if (board.isEmpty(from) || board.colorAt(from) != side) {
+        return false;
+    }
+    return (pieceAttacks(board.kindAt(from), from, board.occupied()) & ~board.piecesOf(side) & target) != 0;
+}
+
+/**
+ * @brief Шахи и связки стороны, делающей ход
+ *
+ * Строится по картам атак доски и таблицам BETWEEN/LINE без пробных ходов.
+ */
+struct CheckInfo {
+    int king = -1;               ///< Клетка своего короля (-1 — короля нет, годится любой ход)
+    Bitboard checkers = 0;       ///< Фигуры соперника, объявившие шах
+    /// Куда может пойти не король: без шаха — любая клетка, при шахе — шахующая фигура
+    /// и клетки между ней и королём, при двойном шахе — никуда
+    Bitboard evasions = ~Bitboard(0);
+    Bitboard pinned = 0;         ///< Свои фигуры, связанные с королём
+    Bitboard kingDanger = 0;     ///< Клетки, закрытые королю: атакованные и за ним на линии шаха
+};
+
+/**
+ * @brief Найти шахи и связки
+ * @param board Позиция
+ * @return Сведения для проверки законности ходов стороны, делающей ход
+ */
+inline CheckInfo computeCheckInfo(const Board& board) {
+    CheckInfo info;
+    Color side = board.getSideToMove();
+    Color them = opposite(side);
+    info.king = board.kingSquare(side);
+    if (info.king < 0) {
+        return info;
+    }
+    Bitboard occupied = board.occupied();
+    Bitboard queens = board.piecesOf(them, PieceKind::QUEEN);
+    Bitboard orthogonal = board.piecesOf(them, PieceKind::ROOK) | queens;
+    Bitboard diagonal = board.piecesOf(them, PieceKind::BISHOP) | queens;
+    info.kingDanger = board.attackedBy(them);
+    if (board.attackerCount(info.king, them) > 0) {
+        info.checkers = board.attackersTo(info.king, occupied) & board.piecesOf(them);
+        info.evasions = (info.checkers & (info.checkers - 1)) ? 0
+                      : info.checkers | BETWEEN[info.king][lowestSquare(info.checkers)];
+        // Король не уходит вдоль линии дальнобойной шахующей фигуры
+        for (Bitboard b = info.checkers & (orthogonal | diagonal); b; ) {
+            int sq = popLowestSquare(b);
+            info.kingDanger |= LINE[sq][info.king] & ~squareBit(sq);
+        }
+    }
+    for (Bitboard b = orthogonal | diagonal; b; ) {
+        int sq = popLowestSquare(b);
+        bool straight = squareX(sq) == squareX(info.king) || squareY(sq) == squareY(info.king);
+        if (!LINE[sq][info.king] || !((straight ? orthogonal : diagonal) & squareBit(sq))) {
+            continue;
+        }
+        Bitboard blockers = BETWEEN[sq][info.king] & occupied;
+        if (blockers && !(blockers & (blockers - 1))) {
+            info.pinned |= blockers & board.piecesOf(side);
+        }
+    }
+    return info;
+}
+
+/**
+ * @brief Проверить, что псевдолегальный ход не оставляет короля под шахом
+ * @param move Псевдолегальный ход
+ * @param info Шахи и связки позиции (computeCheckInfo)
+ * @return true если ход законен
+ */
+inline bool isLegal(Move move, const CheckInfo& info) {
+    if (info.king < 0) {
+        return true;
+    }
+    Bitboard target = squareBit(move.to());
+    if (move.isDrop()) {
+        return (info.evasions & target) != 0;
+    }
+    int from = move.from();
+    if (from == info.king) {
+        return !(info.kingDanger & target);
+    }
+    return (info.evasions & target) && (!(info.pinned & squareBit(from)) || (LINE[info.king][from] & target));
+}
+
+/**
+ * @brief Проверить, что псевдолегальный ход не оставляет короля под шахом
+ * @param board Позиция
+ * @param move Псевдолегальный ход
+ * @return true если ход законен
+ */
+inline bool isLegal(const Board& board, Move move) {
+    return isLegal(move, computeCheckInfo(board));
+}
+
+/**
+ * @brief Сгенерировать законные ходы стороны, делающей ход
+ * @param board Позиция
+ * @param[out] list Список законных ходов (предыдущее содержимое удаляется)
+ *
+ * Ходы не пробуются на копии доски: цели короля ограничиваются картой атак
+ * соперника, остальных фигур и сбросов — клетками, снимающими шах, а связанных
+ * фигур — линией связки. Порядок ходов тот же, что у generatePseudoLegalMoves.
+ */
+inline void generateLegalMoves(const Board& board, MoveList& list) {
+    list.size = 0;
+    CheckInfo info = computeCheckInfo(board);
+    if (info.king < 0) {
+        generatePseudoLegalMoves(board, list);
+        return;
+    }
+    Color side = board.getSideToMove();
+    Bitboard own = board.piecesOf(side);
+    Bitboard occupied = board.occupied();
+    for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+        PieceKind kind = static_cast<PieceKind>(k);
+        Bitboard from = board.piecesOf(side, kind);
+        if (kind != PieceKind::KING && !info.evasions) {
+            continue;
+        }
+        while (from) {
+            int sq = popLowestSquare(from);
+            Bitboard targets = pieceAttacks(kind, sq, occupied) & ~own;
+            if (kind == PieceKind::KING) {
+                targets &= ~info.kingDanger;
+            } else {
+                targets &= info.evasions;
+                if (info.pinned & squareBit(sq)) {
+                    targets &= LINE[info.king][sq];
+                }
+            }
+            while (targets) {
+                list.add(Move::normal(sq, popLowestSquare(targets)));
+            }
+        }
+    }
+    if (board.getVariant() == Board::Variant::CRAZYHOUSE && info.evasions) {
+        for (int k = 0; k < static_cast<int>(PieceKind::KING); ++k) {
+            PieceKind kind = static_cast<PieceKind>(k);
+            if (board.getPocketCount(side, kind) == 0) {
+                continue;
+            }
+            for (Bitboard targets = board.dropTargets(kind) & info.evasions; targets; ) {
+                list.add(Move::drop(kind, popLowestSquare(targets)));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Проверить, является ли ход взятием
+ * @param board Позиция до хода
+ * @param move Ход
+ * @return true если на целевой клетке стоит фигура соперника
+ */
+inline bool isCapture(const Board& board, Move move) {
+    return !move.isDrop() && !board.isEmpty(move.to());
+}
+
+/**
+ * @brief Буква фигуры в нотации (заглавная для белых)
+ * @param kind Вид фигуры
+ * @param col Цвет фигуры
+ * @return Символ N, B, R, Q или K в нужном регистре
+ */
+inline char pieceLetter(PieceKind kind, Color col) {
+    static const char letters[PIECE_KIND_COUNT] = {'N', 'B', 'R', 'Q', 'K'};
+    char letter = letters[static_cast<int>(kind)];
+    return col == Color::WHITE ? letter : static_cast<char>(letter - 'A' + 'a');
+}
+
+/**
+ * @brief Разобрать букву фигуры
+ * @param letter Символ N, B, R, Q или K в любом регистре
+ * @param[out] kind Вид фигуры
+ * @return false если символ не обозначает фигуру
+ */
+inline bool parsePieceLetter(char letter, PieceKind& kind) {
+    switch (letter) {
+    case 'N': case 'n': kind = PieceKind::KNIGHT; return true;
+    case 'B': case 'b': kind = PieceKind::BISHOP; return true;
+    case 'R': case 'r': kind = PieceKind::ROOK; return true;
+    case 'Q': case 'q': kind = PieceKind::QUEEN; return true;
+    case 'K': case 'k': kind = PieceKind::KING; return true;
+    default: return false;
+    }
+}
+
+/**
+ * @brief Записать имя клетки в буфер
+ * @param out Буфер не короче 2 байт
+ * @param sq Номер клетки
+ * @return Указатель за последним записанным символом
+ */
+inline char* formatSquare(char* out, int sq) {
+    *out++ = static_cast<char>('a' + squareX(sq));
+    *out++ = static_cast<char>('1' + squareY(sq));
+    return out;
+}
+
+/**
+ * @brief Имя клетки в алгебраической нотации
+ * @param sq Номер клетки
+ * @return Строка вида "e4" (x — вертикаль a-h, y — горизонталь 1-8)
+ */
+inline std::string squareName(int sq) {
+    char buffer[2];
+    return std::string(buffer, formatSquare(buffer, sq));
+}
+
+constexpr std::size_t MOVE_TEXT_MAX = 4; ///< Наибольшая длина хода в координатной нотации
+
+/**
+ * @brief Записать ход в координатной нотации в буфер без выделения памяти
+ * @param out Буфер не короче MOVE_TEXT_MAX байт
+ * @param move Ход
+ * @return Указатель за последним записанным символом (завершающий ноль не пишется)
+ */
+inline char* formatMove(char* out, Move move) {
+    if (move.isDrop()) {
+        *out++ = pieceLetter(move.dropKind(), Color::WHITE);
+        *out++ = '@';
+    } else {
+        out = formatSquare(out, move.from());
+    }
+    return formatSquare(out, move.to());
+}
+
+/**
+ * @brief Записать ход в координатной нотации
+ * @param move Ход
+ * @return Строка вида "e2e4" или "N@e4" для сброса
+ */
+inline std::string moveToString(Move move) {
+    char buffer[MOVE_TEXT_MAX];
+    return std::string(buffer, formatMove(buffer, move));
+}
+
+/**
+ * @brief Разобрать ход в координатной нотации и проверить его законность
+ * @param board Позиция
+ * @param text Ход вида "e2e4" или "N@e4"
+ * @return Законный ход
+ * @throws std::invalid_argument если запись некорректна или ход незаконен
+ */
+inline Move parseMove(const Board& board, const std::string& text) {
+    auto parseSquare = [&text](std::size_t pos) {
+        char file = text[pos];
+        char rank = text[pos + 1];
+        if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+            throw std::invalid_argument("Некорректная клетка в записи хода: " + text);
+        }
+        return makeSquare(file - 'a', rank - '1');
+    };
+    Move move;
+    PieceKind kind;
+    if (text.size() == 4 && text[1] == '@' && parsePieceLetter(text[0], kind)) {
+        move = Move::drop(kind, parseSquare(2));
+    } else if (text.size() == 4) {
+        move = Move::normal(parseSquare(0), parseSquare(2));
+    } else {
+        throw std::invalid_argument("Некорректная запись хода: " + text);
+    }
+    MoveList legal;
+    generateLegalMoves(board, legal);
+    for (Move candidate : legal) {
+        if (candidate == move) {
+            return move;
+        }
+    }
+    throw std::invalid_argument("Незаконный ход: " + text);
+}
+
+/**
+ * @brief Записать ход в стандартной алгебраической нотации (SAN)
+ * @param board Позиция до хода
+ * @param move Законный ход
+ * @return Строка вида "Nbd7", "Rxe8+" или "Q@f7#"
+ */
+inline std::string moveToSan(const Board& board, Move move) {
+    std::string san;
+    if (move.isDrop()) {
+        san = std::string{pieceLetter(move.dropKind(), Color::WHITE), '@'} + squareName(move.to());
+    } else {
+        PieceKind kind = board.kindAt(move.from());
+        san += pieceLetter(kind, Color::WHITE);
+        // Уточнение исходной клетки, если такой же фигурой можно пойти туда же
+        MoveList legal;
+        generateLegalMoves(board, legal);
+        bool ambiguous = false, sameFile = false, sameRank = false;
+        for (Move other : legal) {
+            if (other == move || other.isDrop() || other.to() != move.to()
+                || board.kindAt(other.from()) != kind) {
+                continue;
+            }
+            ambiguous = true;
+            sameFile |= squareX(other.from()) == squareX(move.from());
+            sameRank |= squareY(other.from()) == squareY(move.from());
+        }
+        if (ambiguous) {
+            std::string from = squareName(move.from());
+            if (!sameFile) san += from[0];
+            else if (!sameRank) san += from[1];
+            else san += from;
+        }
+        if (isCapture(board, move)) {
+            san += 'x';
+        }
+        san += squareName(move.to());
+    }
+    Board next = board;
+    next.makeMove(move);
+    if (next.inCheck(next.getSideToMove())) {
+        MoveList replies;
+        generateLegalMoves(next, replies);
+        san += replies.size == 0 ? '#' : '+';
+    }
+    return san;
+}
+
+/**
+ * @brief Разобрать ход в нотации SAN или в координатной нотации
+ * @param board Позиция
+ * @param text Ход вида "Nbd7", "Rxe8+", "N@e4" или "e2e4"
+ * @return Законный ход
+ * @throws std::invalid_argument если запись некорректна, неоднозначна или ход незаконен
+ */
+inline Move parseSan(const Board& board, const std::string& text) {
+    std::string san = text;
+    while (!san.empty() && (san.back() == '+' || san.back() == '#'
+                            || san.back() == '!' || san.back() == '?')) {
+        san.pop_back();
+    }
+    PieceKind kind;
+    if (san.size() < 3 || !parsePieceLetter(san[0], kind) || san[0] >= 'a' || san[1] == '@') {
+        return parseMove(board, san);
+    }
+    std::string target = san.substr(san.size() - 2);
+    std::string hint = san.substr(1, san.size() - 3);
+    if (!hint.empty() && hint.back() == 'x') {
+        hint.pop_back();
+    }
+    if (target[0] < 'a' || target[0] > 'h' || target[1] < '1' || target[1] > '8' || hint.size() > 2) {
+        throw std::invalid_argument("Некорректная запись хода: " + text);
+    }
+    int to = makeSquare(target[0] - 'a', target[1] - '1');
+    MoveList legal;
+    generateLegalMoves(board, legal);
+    Move found;
+    int matches = 0;
+    for (Move move : legal) {
+        if (move.isDrop() || move.to() != to || board.kindAt(move.from()) != kind) {
+            continue;
+        }
+        std::string from = squareName(move.from());
+        bool fits = true;
+        for (char c : hint) {
+            fits &= (c >= 'a' && c <= 'h') ? c == from[0] : c == from[1];
+        }
+        if (fits) {
+            found = move;
+            ++matches;
+        }
+    }
+    if (matches == 0) {
+        throw std::invalid_argument("Незаконный ход: " + text);
+    }
+    if (matches > 1) {
+        throw std::invalid_argument("Неоднозначный ход: " + text);
+    }
+    return found;
+}
+
+}
+
+#endif
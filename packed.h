@@ -0,0 +1,151 @@
+#ifndef CHESS_PACKED_H
+#define CHESS_PACKED_H
+
+#include "board.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Позиция, упакованная в 32 байта
+ *
+ * Байты 0-7 — битовая доска занятых клеток, 8-23 — два 64-битных слова
+ * с 4-битными кодами фигур по возрастанию номеров занятых клеток (до 32 фигур),
+ * 24-31 — состояние: бит 0 — очередь хода (1 — чёрные), биты 1-4 — права
+ * на рокировку, биты 5-11 — клетка взятия на проходе (бит 11 — признак наличия),
+ * биты 12-18 — счётчик полуходов (не больше 127), биты 19-34 — номер хода,
+ * остальные биты нулевые. Многобайтовые поля записаны в порядке little-endian.
+ *
+ * Представление каноническое: одинаковые позиции дают одинаковые байты,
+ * поэтому его можно сравнивать и хэшировать побайтно. Все поля имеют
+ * фиксированные смещения, и кодирование сводится к сдвигам 64-битных слов
+ * без ветвлений по содержимому клеток.
+ */
+struct PackedPosition {
+    std::array<std::uint8_t, 32> bytes{};
+
+    bool operator==(const PackedPosition& other) const { return bytes == other.bytes; }
+    bool operator!=(const PackedPosition& other) const { return bytes != other.bytes; }
+};
+
+static_assert(sizeof(PackedPosition) == 32, "Упакованная позиция должна занимать 32 байта");
+
+constexpr int PACKED_MAX_PIECES = 32;        ///< Наибольшее число фигур в упакованной позиции
+constexpr int PACKED_HALFMOVE_LIMIT = 127;   ///< Наибольший хранимый счётчик полуходов
+
+/**
+ * @brief Код фигуры в упакованной позиции
+ * @param col Цвет
+ * @param kind Вид
+ * @return 1-5 для белых коня, слона, ладьи, ферзя и короля; +8 для чёрных
+ *
+ * Коды 6 и 14 зарезервированы для пешек, 0 не используется.
+ */
+constexpr std::uint8_t packedPieceCode(Color col, PieceKind kind) {
+    return static_cast<std::uint8_t>(static_cast<int>(kind) + 1 + (col == Color::BLACK ? 8 : 0));
+}
+
+namespace detail {
+
+inline std::uint64_t loadWord(const PackedPosition& packed, int offset) {
+    std::uint64_t word;
+    std::memcpy(&word, packed.bytes.data() + offset, 8);
+    return word;
+}
+
+inline void storeWord(PackedPosition& packed, int offset, std::uint64_t word) {
+    std::memcpy(packed.bytes.data() + offset, &word, 8);
+}
+
+} // namespace detail
+
+/**
+ * @brief Упаковать позицию
+ * @param board Позиция классического варианта
+ * @return 32-байтовое каноническое представление
+ * @throws std::invalid_argument если на доске больше 32 фигур или это вариант с карманами
+ *
+ * Счётчик полуходов больше 127 сохраняется как 127: для правила 50 ходов
+ * важно лишь, достиг ли он 100.
+ */
+inline PackedPosition packPosition(const Board& board) {
+    if (board.getVariant() != Board::Variant::STANDARD) {
+        throw std::invalid_argument("Упаковываются только позиции классического варианта");
+    }
+    Bitboard occupied = board.occupied();
+    if (popCount(occupied) > PACKED_MAX_PIECES) {
+        throw std::invalid_argument("На доске больше 32 фигур");
+    }
+    std::uint64_t codes[2] = {0, 0};
+    int index = 0;
+    for (Bitboard b = occupied; b; ++index) {
+        int sq = popLowestSquare(b);
+        std::uint64_t code = packedPieceCode(board.colorAt(sq), board.kindAt(sq));
+        codes[index >> 4] |= code << (4 * (index & 15));
+    }
+    std::uint64_t state = (board.getSideToMove() == Color::BLACK ? 1u : 0u)
+        | (std::uint64_t(std::min(board.getHalfmoveClock(), PACKED_HALFMOVE_LIMIT)) << 12)
+        | (std::uint64_t(std::min(board.getFullmoveNumber(), 0xFFFF)) << 19);
+    PackedPosition packed;
+    detail::storeWord(packed, 0, occupied);
+    detail::storeWord(packed, 8, codes[0]);
+    detail::storeWord(packed, 16, codes[1]);
+    detail::storeWord(packed, 24, state);
+    return packed;
+}
+
+/**
+ * @brief Распаковать позицию
+ * @param packed 32-байтовое представление
+ * @return Доска с позицией
+ * @throws std::invalid_argument если представление не каноническое: больше 32 фигур,
+ *         неизвестный код фигуры, ненулевые неиспользуемые коды или биты состояния,
+ *         права на рокировку или взятие на проходе
+ */
+inline Board unpackPosition(const PackedPosition& packed) {
+    Bitboard occupied = detail::loadWord(packed, 0);
+    std::uint64_t codes[2] = {detail::loadWord(packed, 8), detail::loadWord(packed, 16)};
+    std::uint64_t state = detail::loadWord(packed, 24);
+    int count = popCount(occupied);
+    if (count > PACKED_MAX_PIECES) {
+        throw std::invalid_argument("В упакованной позиции больше 32 фигур");
+    }
+    // Коды после последней фигуры должны быть нулевыми
+    for (int word = 0; word < 2; ++word) {
+        int used = std::max(0, std::min(16, count - 16 * word));
+        if (used < 16 && (codes[word] >> (4 * used)) != 0) {
+            throw std::invalid_argument("Ненулевые коды после последней фигуры");
+        }
+    }
+    if ((state >> 35) != 0 || (state & 0xFFE) != 0) {
+        throw std::invalid_argument("Рокировка, взятие на проходе и резервные биты не поддерживаются");
+    }
+
+    Board board;
+    int index = 0;
+    for (Bitboard b = occupied; b; ++index) {
+        int sq = popLowestSquare(b);
+        int code = static_cast<int>((codes[index >> 4] >> (4 * (index & 15))) & 15);
+        int kind = (code & 7) - 1;
+        if (kind < 0 || kind >= PIECE_KIND_COUNT) {
+            throw std::invalid_argument("Неизвестный код фигуры в упакованной позиции");
+        }
+        board.putPiece(code & 8 ? Color::BLACK : Color::WHITE, static_cast<PieceKind>(kind), sq);
+    }
+    board.setSideToMove(state & 1 ? Color::BLACK : Color::WHITE);
+    board.setMoveCounters(static_cast<int>((state >> 12) & 0x7F), static_cast<int>((state >> 19) & 0xFFFF));
+    return board;
+}
+
+}
+
+#endif
@@ -0,0 +1,361 @@
+#ifndef CHESS_PLACEMENT_H
+#define CHESS_PLACEMENT_H
+
+#include "board.h"
+#include "symmetry.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Расстановка фигур: битовая доска для каждого вида фигуры
+ */
+using Placement = std::array<Bitboard, PIECE_KIND_COUNT>;
+
+/**
+ * @brief Количество фигур каждого вида в задаче о расстановке
+ */
+using PieceCounts = std::array<int, PIECE_KIND_COUNT>;
+
+namespace detail {
+
+/**
+ * @brief Наименьшие клетки орбит симметрий доски
+ * @return Для каждой клетки — наименьший номер среди её восьми образов
+ */
+constexpr std::array<int, SQUARE_COUNT> makeOrbitMinimum() {
+    std::array<int, SQUARE_COUNT> minimum{};
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        minimum[sq] = sq;
+        for (int s = 1; s < 8; ++s) {
+            minimum[sq] = std::min(minimum[sq], transformSquare(sq, s));
+        }
+    }
+    return minimum;
+}
+
+inline constexpr std::array<int, SQUARE_COUNT> ORBIT_MINIMUM = makeOrbitMinimum();
+
+/**
+ * @brief Клетки, допустимые в канонической расстановке с младшей фигурой на first
+ * @return Для каждой клетки first — клетки, ни один образ которых не младше first
+ */
+constexpr std::array<Bitboard, SQUARE_COUNT> makeSymmetryAllowed() {
+    std::array<Bitboard, SQUARE_COUNT> allowed{};
+    for (int first = 0; first < SQUARE_COUNT; ++first) {
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            if (ORBIT_MINIMUM[sq] >= first) {
+                allowed[first] |= squareBit(sq);
+            }
+        }
+    }
+    return allowed;
+}
+
+constexpr Bitboard makeFundamentalSquares() {
+    Bitboard squares = 0;
+    for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+        if (ORBIT_MINIMUM[sq] == sq) {
+            squares |= squareBit(sq);
+        }
+    }
+    return squares;
+}
+
+} // namespace detail
+
+/// Клетки, допустимые в канонической расстановке, по клетке её младшей фигуры
+inline constexpr std::array<Bitboard, SQUARE_COUNT> SYMMETRY_ALLOWED = detail::makeSymmetryAllowed();
+
+/// Фундаментальная область: клетки, наименьшие в своей орбите (a1-d1, b2-d2, c3-d3, d4)
+inline constexpr Bitboard FUNDAMENTAL_SQUARES = detail::makeFundamentalSquares();
+
+/**
+ * @brief Решатель задач о неатакующих расстановках фигур
+ *
+ * Считает и перечисляет расстановки заданного набора фигур (восемь ферзей,
+ * восемь ладей, максимум коней и т. п.), в которых ни одна фигура не бьёт другую
+ * с учётом блокировки лучей. Клетки заполняются по возрастанию номера, поэтому
+ * одинаковые фигуры не переставляются между собой, а все клетки между уже
+ * поставленной фигурой и новой окончательно известны — проверка атак точна.
+ * Поддерево поиска делится на задачи, которые разбирают рабочие потоки.
+ *
+ * При подсчёте с точностью до симметрий перебор сужается сразу: у канонической
+ * расстановки (см. isCanonical) младшая фигура стоит на клетке, наименьшей
+ * в своей орбите, а остальные — на клетках, вся орбита которых не младше её.
+ * Поэтому первая фигура ставится только в фундаментальную область доски,
+ * а для остальных заранее вычеркнуты клетки, образы которых младше первой.
+ * Законченные расстановки затем проверяются isCanonical полностью.
+ */
+class PlacementSolver {
+private:
+    PieceCounts counts;
+    int total;
+
+    /**
+     * @brief Состояние частичной расстановки
+     */
+    struct State {
+        Placement placed;
+        PieceCounts remaining;
+        Bitboard occupied;
+        int nextSquare;
+        int left;
+        bool uniqueOnly;      // ставить фигуры только туда, где расстановка может быть канонической
+    };
+
+    /**
+     * @brief Клетки, атакованные уже поставленными фигурами
+     */
+    static Bitboard attackedBy(const State& state) {
+        Bitboard attacked = 0;
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            Bitboard b = state.placed[k];
+            while (b) {
+                attacked |= pieceAttacks(static_cast<PieceKind>(k), popLowestSquare(b), state.occupied);
+            }
+        }
+        return attacked;
+    }
+
+    /**
+     * @brief Перебрать все допустимые продолжения на один шаг
+     * @param state Текущее состояние
+     * @param visit Вызывается для каждого дочернего состояния
+     */
+    template <class Visitor>
+    static void expand(const State& state, Visitor&& visit) {
+        Bitboard candidates = ~state.occupied & ~attackedBy(state)
+                              & (~Bitboard(0) << state.nextSquare);
+        // Первая фигура канонической расстановки — в фундаментальной области,
+        // остальные — на клетках, допустимых при этой первой
+        Bitboard squares = ~Bitboard(0);
+        if (state.uniqueOnly && state.occupied) {
+            candidates &= SYMMETRY_ALLOWED[lowestSquare(state.occupied)];
+        } else if (state.uniqueOnly) {
+            squares = FUNDAMENTAL_SQUARES;
+        }
+        while (candidates) {
+            int sq = popLowestSquare(candidates);
+            // Оставшимся фигурам должно хватить свободных неатакованных клеток
+            if (popCount(candidates) + 1 < state.left) {
+                return;
+            }
+            if (!(squares & squareBit(sq))) {
+                continue;
+            }
+            for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+                if (state.remaining[k] == 0) {
+                    continue;
+                }
+                if (pieceAttacks(static_cast<PieceKind>(k), sq, state.occupied) & state.occupied) {
+                    continue;
+                }
+                State child = state;
+                child.placed[k] |= squareBit(sq);
+                child.occupied |= squareBit(sq);
+                --child.remaining[k];
+                --child.left;
+                child.nextSquare = sq + 1;
+                visit(child);
+            }
+        }
+    }
+
+    /**
+     * @brief Вид фигуры на клетке
+     * @return Номер вида или PIECE_KIND_COUNT для пустой клетки
+     */
+    static int kindOn(const Placement& placement, Bitboard bit) {
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            if (placement[k] & bit) {
+                return k;
+            }
+        }
+        return PIECE_KIND_COUNT;
+    }
+
+    /**
+     * @brief Сравнить расстановки по клеткам в порядке возрастания номера
+     * @return Меньше нуля, если на младшей различающейся клетке у a фигура
+     *         меньшего вида (пустая клетка больше любой фигуры); 0 если совпадают
+     */
+    static int compare(const Placement& a, const Placement& b) {
+        Bitboard diff = 0;
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            diff |= a[k] ^ b[k];
+        }
+        if (!diff) {
+            return 0;
+        }
+        Bitboard bit = diff & (~diff + 1);
+        return kindOn(a, bit) - kindOn(b, bit);
+    }
+
+    template <class Visitor>
+    static void search(const State& state, Visitor& visit) {
+        if (state.left == 0) {
+            if (!state.uniqueOnly || isCanonical(state.placed)) {
+                visit(state.placed);
+            }
+            return;
+        }
+        expand(state, [&visit](const State& child) { search(child, visit); });
+    }
+
+    State rootState(bool uniqueOnly) const {
+        State root{};
+        root.remaining = counts;
+        root.left = total;
+        root.uniqueOnly = uniqueOnly;
+        return root;
+    }
+
+    /**
+     * @brief Разбить дерево поиска на независимые поддеревья
+     * @param depth Глубина разбиения
+     * @param uniqueOnly Искать только канонические расстановки
+     * @return Состояния-корни поддеревьев в порядке обхода
+     */
+    std::vector<State> splitTasks(int depth, bool uniqueOnly) const {
+        std::vector<State> tasks{rootState(uniqueOnly)};
+        for (int d = 0; d < depth; ++d) {
+            std::vector<State> next;
+            for (const State& state : tasks) {
+                if (state.left == 0) {
+                    next.push_back(state);
+                } else {
+                    expand(state, [&next](const State& child) { next.push_back(child); });
+                }
+            }
+            tasks.swap(next);
+        }
+        return tasks;
+    }
+
+    /**
+     * @brief Обработать поддеревья в нескольких потоках
+     * @param tasks Корни поддеревьев
+     * @param threads Количество потоков (0 — по числу ядер)
+     * @param runTask Вызывается с номером задачи и её корнем
+     *
+     * Потоки забирают задачи из общего атомарного счётчика,
+     * поэтому неравные по размеру поддеревья распределяются динамически.
+     */
+    template <class Task>
+    static void runParallel(const std::vector<State>& tasks, unsigned threads, Task&& runTask) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::atomic<std::size_t> nextTask(0);
+        auto worker = [&]() {
+            for (std::size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+                runTask(i, tasks[i]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+    }
+
+    static constexpr int SPLIT_DEPTH = 2; ///< Глубина разбиения дерева на задачи
+
+public:
+    /**
+     * @brief Конструктор решателя
+     * @param pieceCounts Количество фигур каждого вида
+     * @throws std::invalid_argument если количества отрицательны или фигур больше 64
+     */
+    explicit PlacementSolver(const PieceCounts& pieceCounts)
+    : counts(pieceCounts), total(0) {
+        for (int count : counts) {
+            if (count < 0) {
+                throw std::invalid_argument("Количество фигур не может быть отрицательным");
+            }
+            total += count;
+        }
+        if (total > SQUARE_COUNT) {
+            throw std::invalid_argument("Фигур больше, чем клеток на доске");
+        }
+    }
+
+    /**
+     * @brief Проверить, что расстановка минимальна среди своих симметричных образов
+     * @param placement Расстановка
+     * @return true если расстановка является представителем класса симметрии
+     *
+     * Расстановки сравниваются по клеткам в порядке возрастания номера:
+     * меньше та, у которой на первой различающейся клетке фигура меньшего
+     * вида, а пустая клетка больше любой фигуры. Значит, у канонической
+     * расстановки младшая занятая клетка — наименьшая среди всех образов.
+     */
+    static bool isCanonical(const Placement& placement) {
+        for (int s = 1; s < 8; ++s) {
+            Placement image{};
+            for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+                image[k] = transformBitboard(placement[k], s);
+            }
+            if (compare(image, placement) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Посчитать все расстановки
+     * @param threads Количество потоков (0 — по числу ядер)
+     * @param uniqueOnly Считать только расстановки, различные с точностью до симметрий доски
+     * @return Количество расстановок
+     */
+    std::uint64_t count(unsigned threads = 0, bool uniqueOnly = false) const {
+        std::atomic<std::uint64_t> result(0);
+        runParallel(splitTasks(SPLIT_DEPTH, uniqueOnly), threads, [&](std::size_t, const State& task) {
+            std::uint64_t local = 0;
+            auto visit = [&local](const Placement&) { ++local; };
+            search(task, visit);
+            result += local;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Перечислить все расстановки
+     * @param threads Количество потоков (0 — по числу ядер)
+     * @param uniqueOnly Выдавать только по одному представителю класса симметрии
+     * @return Расстановки в порядке возрастания клеток
+     */
+    std::vector<Placement> enumerate(unsigned threads = 0, bool uniqueOnly = false) const {
+        std::vector<State> tasks = splitTasks(SPLIT_DEPTH, uniqueOnly);
+        std::vector<std::vector<Placement>> partial(tasks.size());
+        runParallel(tasks, threads, [&](std::size_t index, const State& task) {
+            auto visit = [&partial, index](const Placement& placement) { partial[index].push_back(placement); };
+            search(task, visit);
+        });
+        std::vector<Placement> result;
+        for (std::vector<Placement>& part : partial) {
+            result.insert(result.end(), part.begin(), part.end());
+        }
+        return result;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef CHESS_PUZZLE_H
+#define CHESS_PUZZLE_H
+
+#include "fen.h"
+#include "search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Шахматная задача: позиция и ожидаемое решение
+ */
+struct Puzzle {
+    std::string id;                     ///< Идентификатор задачи
+    std::string fen;                    ///< Начальная позиция
+    std::vector<std::string> solution;  ///< Ходы решения: свои и ответы соперника поочерёдно
+};
+
+/**
+ * @brief Итог решения задачи
+ */
+enum class PuzzleStatus {
+    SOLVED, /**< Все свои ходы совпали с решением */
+    FAILED, /**< Движок нашёл другой ход */
+    ERROR   /**< Строка или позиция некорректна */
+};
+
+/**
+ * @brief Результат решения одной задачи
+ */
+struct PuzzleResult {
+    std::string id;
+    PuzzleStatus status = PuzzleStatus::ERROR;
+    double timeMs = 0;           ///< Время решения
+    std::uint64_t nodes = 0;     ///< Суммарное число узлов перебора
+    std::string found;           ///< Ходы, найденные движком
+    std::string error;           ///< Описание ошибки для статуса ERROR
+};
+
+/**
+ * @brief Разобрать строку CSV с задачей
+ * @param line Строка вида "id,FEN,ход1 ход2 ..."
+ * @return Задача
+ * @throws std::invalid_argument если полей меньше трёх или решение пусто
+ */
+inline Puzzle parsePuzzleLine(const std::string& line) {
+    std::size_t first = line.find(',');
+    std::size_t second = first == std::string::npos ? first : line.find(',', first + 1);
+    if (second == std::string::npos) {
+        throw std::invalid_argument("Строка задачи должна содержать поля id,FEN,решение");
+    }
+    Puzzle puzzle;
+    puzzle.id = line.substr(0, first);
+    puzzle.fen = line.substr(first + 1, second - first - 1);
+    std::istringstream moves(line.substr(second + 1));
+    for (std::string move; moves >> move; ) {
+        puzzle.solution.push_back(move);
+    }
+    if (puzzle.solution.empty()) {
+        throw std::invalid_argument("Решение задачи пусто");
+    }
+    return puzzle;
+}
+
+/**
+ * @brief Проверить, ставит ли ход мат
+ * @param board Позиция до хода
+ * @param move Законный ход
+ * @return true если после хода у соперника нет законных ходов и он под шахом
+ */
+inline bool isCheckmateMove(const Board& board, Move move) {
+    Board next = board;
+    next.makeMove(move);
+    MoveList replies;
+    generateLegalMoves(next, replies);
+    return replies.size == 0 && next.inCheck(next.getSideToMove());
+}
+
+/**
+ * @brief Решить задачу движком и сверить ответ
+ * @param puzzle Задача
+ * @param limits Ограничения перебора на каждый свой ход
+ * @return Результат; исключения разбора превращаются в статус ERROR
+ *
+ * На каждом своём ходу сначала ищется форсированный мат не длиннее оставшегося
+ * решения, затем, если мата нет, выполняется обычный перебор. Лимиты узлов
+ * и времени общие на ход: обычный перебор получает то, что не израсходовал
+ * поиск мата. Ход считается
+ * верным, если совпадает с ожидаемым или, будучи последним, тоже ставит мат.
+ */
+inline PuzzleResult solvePuzzle(const Puzzle& puzzle, const SearchLimits& limits) {
+    PuzzleResult result;
+    result.id = puzzle.id;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        Board board = parseFen(puzzle.fen);
+        std::vector<std::uint64_t> history;
+        result.status = PuzzleStatus::SOLVED;
+        for (std::size_t ply = 0; ply < puzzle.solution.size(); ++ply) {
+            Move expected = parseMove(board, puzzle.solution[ply]);
+            if (ply % 2 == 0) {
+                auto moveStart = std::chrono::steady_clock::now();
+                Search search(limits);
+                search.setHistory(history);
+                int movesLeft = static_cast<int>((puzzle.solution.size() - ply + 1) / 2);
+                SearchResult found = search.findMate(board, movesLeft);
+                result.nodes += found.nodes;
+                if (found.bestMove.isNone()) {
+                    // Остаток лимитов хода; 0 в SearchLimits означает «без ограничения»
+                    SearchLimits rest = limits;
+                    if (limits.nodes) {
+                        rest.nodes = std::max<std::uint64_t>(1, limits.nodes - std::min(limits.nodes, found.nodes));
+                    }
+                    if (limits.timeMs) {
+                        auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - moveStart).count();
+                        rest.timeMs = static_cast<int>(std::max<long long>(1, limits.timeMs - spent));
+                    }
+                    Search fallback(rest);
+                    fallback.setHistory(history);
+                    found = fallback.run(board);
+                    result.nodes += found.nodes;
+                }
+                if (!result.found.empty()) result.found += ' ';
+                result.found += moveToString(found.bestMove);
+                bool last = ply + 1 == puzzle.solution.size();
+                if (found.bestMove != expected &&
+                    !(last && !found.bestMove.isNone() && isCheckmateMove(board, found.bestMove)
+                      && isCheckmateMove(board, expected))) {
+                    result.status = PuzzleStatus::FAILED;
+                    break;
+                }
+            }
+            history.push_back(board.getKey());
+            board.makeMove(expected);
+        }
+    } catch (const std::exception& e) {
+        result.status = PuzzleStatus::ERROR;
+        result.error = e.what();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.timeMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    return result;
+}
+
+/**
+ * @brief Записать результат строкой CSV
+ * @param result Результат решения
+ * @return Строка "id,статус,время_мс,узлы,ходы[,ошибка]" без перевода строки
+ */
+inline std::string formatPuzzleResult(const PuzzleResult& result) {
+    static const char* const statusNames[] = {"solved", "failed", "error"};
+    std::ostringstream out;
+    out << result.id << ',' << statusNames[static_cast<int>(result.status)] << ','
+        << static_cast<std::uint64_t>(result.timeMs) << ',' << result.nodes << ',' << result.found;
+    if (result.status == PuzzleStatus::ERROR) {
+        out << ',' << result.error;
+    }
+    return out.str();
+}
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file puzzles.cpp
+ * @brief Пакетная проверка базы шахматных задач
+ *
+ * Читает задачи из CSV ("id,FEN,ход1 ход2 ..."), решает их в пуле потоков
+ * с ограничением узлов на ход и пишет результат по каждой задаче.
+ * Ввод и вывод потоковые: одновременно в памяти находится не больше
+ * нескольких задач на поток, поэтому размер базы не влияет на память.
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread puzzles.cpp -o puzzles
+ */
+#include "puzzle.h"
+#include "thread_pool.h"
+
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Использование: " << argv[0]
+             << " <задачи.csv> <результат.csv> [узлов на ход] [потоков]\n";
+        return 1;
+    }
+    ifstream input(argv[1]);
+    if (!input) {
+        cerr << "Не удалось открыть " << argv[1] << '\n';
+        return 1;
+    }
+    ofstream output(argv[2]);
+    if (!output) {
+        cerr << "Не удалось создать " << argv[2] << '\n';
+        return 1;
+    }
+
+    Chess::SearchLimits limits;
+    limits.nodes = argc > 3 ? stoull(argv[3]) : 200000;
+    Chess::ThreadPool pool(argc > 4 ? stoul(argv[4]) : 0);
+
+    // Окно незавершённых задач: результаты пишутся в порядке входа
+    const size_t window = 4 * pool.size();
+    deque<future<Chess::PuzzleResult>> pending;
+    size_t counts[3] = {0, 0, 0};
+
+    auto writeOldest = [&]() {
+        Chess::PuzzleResult result = pending.front().get();
+        pending.pop_front();
+        ++counts[static_cast<int>(result.status)];
+        output << Chess::formatPuzzleResult(result) << '\n';
+    };
+
+    output << "id,status,time_ms,nodes,moves\n";
+    string line;
+    while (getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#' || line.compare(0, 3, "id,") == 0) {
+            continue;
+        }
+        pending.push_back(pool.submit([line, limits]() {
+            try {
+                return Chess::solvePuzzle(Chess::parsePuzzleLine(line), limits);
+            } catch (const exception& e) {
+                Chess::PuzzleResult result;
+                result.id = line.substr(0, line.find(','));
+                result.error = e.what();
+                return result;
+            }
+        }));
+        if (pending.size() >= window) {
+            writeOldest();
+        }
+    }
+    while (!pending.empty()) {
+        writeOldest();
+    }
+
+    cout << "Решено: " << counts[0] << ", не решено: " << counts[1]
+         << ", ошибок: " << counts[2] << '\n';
+    return counts[1] + counts[2] == 0 ? 0 : 2;
+}
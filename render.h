@@ -0,0 +1,119 @@
+#ifndef CHESS_RENDER_H
+#define CHESS_RENDER_H
+
+#include "fen.h"
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/// Длина диаграммы доски: 8 горизонталей и строка с буквами вертикалей по 18 байт
+constexpr std::size_t DIAGRAM_LENGTH = 9 * 18;
+
+/// Наибольшая длина строки карманов под диаграммой
+constexpr std::size_t POCKET_LINE_MAX = 2 + 2 * PIECE_KIND_COUNT * POCKET_LIMIT + 1;
+
+/**
+ * @brief Что выводить вместе с диаграммой
+ */
+struct RenderOptions {
+    bool fen = false;              ///< Строка FEN под диаграммой
+    const Move* moves = nullptr;   ///< Ходы для вывода строкой (например, партия или вариант)
+    std::size_t moveCount = 0;     ///< Количество ходов
+};
+
+/**
+ * @brief Наибольшая длина вывода renderPosition()
+ * @param options Что выводится вместе с диаграммой
+ * @return Размер буфера, которого гарантированно хватит
+ */
+constexpr std::size_t renderedLength(const RenderOptions& options) {
+    return DIAGRAM_LENGTH + POCKET_LINE_MAX + (options.fen ? FEN_MAX_LENGTH + 1 : 0)
+         + options.moveCount * (MOVE_TEXT_MAX + 1) + 1;
+}
+
+/**
+ * @brief Нарисовать доску в буфер
+ * @param out Буфер не короче DIAGRAM_LENGTH байт
+ * @param board Позиция
+ * @return Указатель за последним записанным символом
+ *
+ * Формат — восемь строк вида "8 r . b q k b . r" сверху вниз и строка
+ * "  a b c d e f g h"; каждая строка заканчивается '\n'. Клетки
+ * заполняются по битовым доскам фигур, строки копируются целиком.
+ */
+inline char* formatDiagram(char* out, const Board& board) {
+    static constexpr char FOOTER[18] = {' ', ' ', 'a', ' ', 'b', ' ', 'c', ' ', 'd', ' ',
+                                        'e', ' ', 'f', ' ', 'g', ' ', 'h', '\n'};
+    char cells[SQUARE_COUNT];
+    std::memset(cells, '.', sizeof(cells));
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            char letter = pieceLetter(static_cast<PieceKind>(k), col);
+            for (Bitboard b = board.piecesOf(col, static_cast<PieceKind>(k)); b; ) {
+                cells[popLowestSquare(b)] = letter;
+            }
+        }
+    }
+    for (int y = 7; y >= 0; --y) {
+        char row[18];
+        row[0] = static_cast<char>('1' + y);
+        for (int x = 0; x < 8; ++x) {
+            row[2 * x + 1] = ' ';
+            row[2 * x + 2] = cells[makeSquare(x, y)];
+        }
+        row[17] = '\n';
+        std::memcpy(out, row, sizeof(row));
+        out += sizeof(row);
+    }
+    std::memcpy(out, FOOTER, sizeof(FOOTER));
+    return out + sizeof(FOOTER);
+}
+
+/**
+ * @brief Нарисовать позицию с карманами, FEN и ходами в буфер без выделения памяти
+ * @param out Буфер не короче renderedLength(options) байт
+ * @param board Позиция
+ * @param options Что выводить вместе с диаграммой
+ * @return Указатель за последним записанным символом
+ *
+ * Для варианта с карманами под диаграммой печатается строка вида "[RQnn]".
+ * Ходы печатаются в координатной нотации через пробел одной строкой.
+ */
+inline char* renderPosition(char* out, const Board& board, const RenderOptions& options = RenderOptions()) {
+    out = formatDiagram(out, board);
+    if (board.getVariant() == Board::Variant::CRAZYHOUSE) {
+        *out++ = '[';
+        for (Color col : {Color::WHITE, Color::BLACK}) {
+            for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+                PieceKind kind = static_cast<PieceKind>(k);
+                int count = board.getPocketCount(col, kind);
+                std::memset(out, pieceLetter(kind, col), static_cast<std::size_t>(count));
+                out += count;
+            }
+        }
+        *out++ = ']';
+        *out++ = '\n';
+    }
+    if (options.fen) {
+        out = formatFen(out, board);
+        *out++ = '\n';
+    }
+    if (options.moveCount > 0) {
+        for (std::size_t i = 0; i < options.moveCount; ++i) {
+            out = formatMove(out, options.moves[i]);
+            *out++ = ' ';
+        }
+        out[-1] = '\n';
+    }
+    return out;
+}
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include "eval.h"
+#include "movegen.h"
+#include "tt.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+constexpr int MAX_PLY = 64;            ///< Максимальная глубина перебора в полуходах
+constexpr int MATE_SCORE = 32000;      ///< Оценка мата в 0 полуходов
+constexpr int INFINITE_SCORE = 32500;  ///< Граница окна поиска
+
+/**
+ * @brief Ограничения перебора
+ */
+struct SearchLimits {
+    int depth = MAX_PLY - 1;   ///< Максимальная глубина в полуходах
+    std::uint64_t nodes = 0;   ///< Лимит узлов (0 — без ограничения)
+    int timeMs = 0;            ///< Лимит времени в миллисекундах (0 — без ограничения)
+};
+
+/**
+ * @brief Результат перебора
+ */
+struct SearchResult {
+    Move bestMove;             ///< Лучший найденный ход (пустой, если ходов нет)
+    int score = 0;             ///< Оценка с точки зрения стороны, делающей ход
+    int depth = 0;             ///< Глубина последней завершённой итерации
+    std::uint64_t nodes = 0;   ///< Количество рассмотренных узлов
+};
+
+/**
+ * @brief Проверить, означает ли оценка форсированный мат
+ * @param score Оценка
+ * @return true если оценка лежит в диапазоне матовых
+ */
+inline bool isMateScore(int score) { return std::abs(score) >= MATE_SCORE - MAX_PLY; }
+
+/**
+ * @brief Перебор с альфа-бета отсечением
+ *
+ * Итеративное углубление, форсированные варианты взятий на листьях,
+ * упорядочивание ходов по ценности взятой фигуры. Повторения позиций
+ * и правило 50 ходов оцениваются как ничья. Один объект Search
+ * не предназначен для одновременного использования из нескольких потоков,
+ * но несколько объектов могут использовать общую таблицу перестановок.
+ */
+class Search {
+private:
+    SearchLimits limits;
+    const EvalParams* params;
+    std::uint64_t nodes;
+    bool stopped;
+    bool mateOnly;
+    std::chrono::steady_clock::time_point startTime;
+    std::vector<std::uint64_t> gameHistory;
+    std::uint64_t pathKeys[MAX_PLY + 1];
+    Move rootBest;
+    std::function<void(const SearchResult&)> onIteration;
+    TranspositionTable* table;
+
+    bool checkLimits() {
+        if (limits.nodes && nodes >= limits.nodes) {
+            stopped = true;
+        } else if (limits.timeMs && (nodes & 1023) == 0) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= limits.timeMs) {
+                stopped = true;
+            }
+        }
+        return stopped;
+    }
+
+    /**
+     * @brief Перевести матовую оценку из «матов от корня» в «маты от узла» и обратно
+     */
+    static int scoreToTable(int score, int ply) {
+        return score >= MATE_SCORE - MAX_PLY ? score + ply : score <= -MATE_SCORE + MAX_PLY ? score - ply : score;
+    }
+
+    static int scoreFromTable(int score, int ply) {
+        return score >= MATE_SCORE - MAX_PLY ? score - ply : score <= -MATE_SCORE + MAX_PLY ? score + ply : score;
+    }
+
+    bool isRepetition(const Board& board, int ply) const {
+        std::uint64_t key = board.getKey();
+        int reach = board.getHalfmoveClock();
+        for (int back = 2; back <= reach; back += 2) {
+            int index = ply - back;
+            if (index >= 0) {
+                if (pathKeys[index] == key) return true;
+            } else {
+                int gameIndex = static_cast<int>(gameHistory.size()) + index;
+                if (gameIndex < 0) break;
+                if (gameHistory[gameIndex] == key) return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Упорядочить ходы: сначала заданный, затем взятия по ценности жертвы
+     */
+    static void orderMoves(const Board& board, MoveList& list, Move first) {
+        int scores[MAX_MOVES];
+        for (int i = 0; i < list.size; ++i) {
+            Move move = list[i];
+            int score = 0;
+            if (move == first) {
+                score = 1 << 20;
+            } else if (isCapture(board, move)) {
+                score = 16 * PIECE_VALUES[static_cast<int>(board.kindAt(move.to()))]
+                        - PIECE_VALUES[static_cast<int>(board.kindAt(move.from()))] + 1;
+                if (board.kindAt(move.to()) == PieceKind::KING) score = 1 << 19;
+            }
+            int j = i;
+            for (; j > 0 && scores[j - 1] < score; --j) {
+                list[j] = list[j - 1];
+                scores[j] = scores[j - 1];
+            }
+            list[j] = move;
+            scores[j] = score;
+        }
+    }
+
+    int quiescence(const Board& board, int alpha, int beta, int ply) {
+        ++nodes;
+        if (checkLimits()) return 0;
+        int standPat = evaluate(board, *params);
+        if (standPat >= beta || ply >= MAX_PLY) return standPat;
+        if (standPat > alpha) alpha = standPat;
+
+        MoveList list;
+        generatePseudoLegalMoves(board, list);
+        orderMoves(board, list, Move());
+        CheckInfo info = computeCheckInfo(board);
+        for (Move move : list) {
+            if (!isCapture(board, move)) break;
+            if (!isLegal(move, info)) continue;
+            Board child = board;
+            child.makeMove(move);
+            int score = -quiescence(child, -beta, -alpha, ply + 1);
+            if (stopped) return 0;
+            if (score >= beta) return score;
+            if (score > alpha) alpha = score;
+        }
+        return alpha;
+    }
+
+    int negamax(const Board& board, int depth, int alpha, int beta, int ply) {
+        pathKeys[ply] = board.getKey();
+        if (ply > 0 && (board.getHalfmoveClock() >= 100 || isInsufficientMaterial(board)
+                        || isRepetition(board, ply))) {
+            return 0;
+        }
+        bool inCheck = board.inCheck(board.getSideToMove());
+        if (depth <= 0 && !mateOnly) return quiescence(board, alpha, beta, ply);
+        // В режиме поиска мата лист без шаха не может быть матом
+        if (depth <= 0 && !inCheck) return 0;
+        if (ply >= MAX_PLY) return evaluate(board, *params);
+        ++nodes;
+        if (checkLimits()) return 0;
+
+        Move ttMove;
+        TTEntry entry;
+        if (table && !mateOnly && table->probe(board.getKey(), entry)) {
+            ttMove = entry.move;
+            int ttScore = scoreFromTable(entry.score, ply);
+            if (ply > 0 && entry.depth >= depth
+                && (entry.bound == Bound::EXACT
+                    || (entry.bound == Bound::LOWER && ttScore >= beta)
+                    || (entry.bound == Bound::UPPER && ttScore <= alpha))) {
+                return ttScore;
+            }
+        }
+
+        MoveList list;
+        generatePseudoLegalMoves(board, list);
+        orderMoves(board, list, ply == 0 && !rootBest.isNone() ? rootBest : ttMove);
+        int alphaOrig = alpha;
+        int best = -INFINITE_SCORE;
+        Move bestMove;
+        int legalCount = 0;
+        CheckInfo info = computeCheckInfo(board);
+        for (Move move : list) {
+            if (!isLegal(move, info)) continue;
+            ++legalCount;
+            if (depth <= 0) return 0; // есть ход — это не мат
+            Board child = board;
+            child.makeMove(move);
+            int score = -negamax(child, depth - 1, -beta, -alpha, ply + 1);
+            if (stopped) return 0;
+            if (score > best) {
+                best = score;
+                bestMove = move;
+                if (ply == 0) rootBest = move;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) break;
+        }
+        if (legalCount == 0) {
+            return inCheck ? -MATE_SCORE + ply : 0;
+        }
+        if (table && !mateOnly) {
+            table->store(board.getKey(), bestMove, scoreToTable(best, ply), depth,
+                         best <= alphaOrig ? Bound::UPPER : best >= beta ? Bound::LOWER : Bound::EXACT);
+        }
+        return best;
+    }
+
+    void prepare() {
+        nodes = 0;
+        stopped = false;
+        rootBest = Move();
+        startTime = std::chrono::steady_clock::now();
+    }
+
+public:
+    /**
+     * @brief Конструктор перебора
+     * @param searchLimits Ограничения по глубине, узлам и времени
+     * @param evalParams Параметры оценки (должны жить дольше объекта Search)
+     */
+    explicit Search(const SearchLimits& searchLimits = SearchLimits(),
+                    const EvalParams& evalParams = DEFAULT_EVAL_PARAMS)
+    : limits(searchLimits), params(&evalParams), nodes(0), stopped(false), mateOnly(false), pathKeys{},
+      table(nullptr) {}
+
+    /**
+     * @brief Задать ключи позиций, предшествовавших корню в партии
+     * @param keys Ключи Зобриста в порядке ходов (без текущей позиции)
+     *
+     * Нужны для распознавания повторений, начавшихся до корня перебора.
+     */
+    void setHistory(const std::vector<std::uint64_t>& keys) { gameHistory = keys; }
+
+    /**
+     * @brief Подключить таблицу перестановок
+     * @param tt Таблица (может быть общей для нескольких объектов Search) или nullptr
+     *
+     * Таблица не используется в режиме поиска мата findMate().
+     */
+    void setTranspositionTable(TranspositionTable* tt) { table = tt; }
+
+    /**
+     * @brief Задать обработчик завершения итерации углубления
+     * @param callback Вызывается с промежуточным результатом после каждой итерации run()
+     */
+    void setIterationCallback(std::function<void(const SearchResult&)> callback) {
+        onIteration = std::move(callback);
+    }
+
+    /**
+     * @brief Найти лучший ход
+     * @param board Позиция
+     * @return Результат последней завершённой итерации углубления
+     */
+    SearchResult run(const Board& board) {
+        prepare();
+        mateOnly = false;
+        SearchResult result;
+        MoveList legal;
+        generateLegalMoves(board, legal);
+        if (legal.size == 0) {
+            result.score = board.inCheck(board.getSideToMove()) ? -MATE_SCORE : 0;
+            return result;
+        }
+        result.bestMove = legal[0];
+        for (int depth = 1; depth <= limits.depth && depth < MAX_PLY; ++depth) {
+            int score = negamax(board, depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+            if (stopped) break;
+            result.bestMove = rootBest;
+            result.score = score;
+            result.depth = depth;
+            result.nodes = nodes;
+            if (onIteration) onIteration(result);
+            if (isMateScore(score)) break;
+        }
+        result.nodes = nodes;
+        return result;
+    }
+
+    /**
+     * @brief Найти форсированный мат
+     * @param board Позиция
+     * @param maxMoves Наибольшее число собственных ходов до мата
+     * @return Результат с ходом, ведущим к кратчайшему мату, или пустым ходом
+     */
+    SearchResult findMate(const Board& board, int maxMoves) {
+        prepare();
+        mateOnly = true;
+        SearchResult result;
+        for (int n = 1; n <= maxMoves && 2 * n - 1 < MAX_PLY; ++n) {
+            int depth = 2 * n - 1;
+            int score = negamax(board, depth, MATE_SCORE - depth - 1, INFINITE_SCORE, 0);
+            if (stopped) break;
+            if (score >= MATE_SCORE - depth) {
+                result.bestMove = rootBest;
+                result.score = score;
+                result.depth = depth;
+                break;
+            }
+        }
+        mateOnly = false;
+        result.nodes = nodes;
+        return result;
+    }
+
+    /**
+     * @brief Количество узлов последнего перебора
+     * @return Число рассмотренных узлов
+     */
+    std::uint64_t getNodeCount() const { return nodes; }
+};
+
+}
+
+#endif
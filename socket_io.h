@@ -0,0 +1,176 @@
+#ifndef CHESS_SOCKET_IO_H
+#define CHESS_SOCKET_IO_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Прочитать из сокета ровно size байт
+ * @param fd Дескриптор
+ * @param data Буфер
+ * @param size Количество байт
+ * @return false при закрытии соединения или ошибке
+ */
+inline bool readFully(int fd, void* data, std::size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Записать в сокет ровно size байт
+ * @param fd Дескриптор
+ * @param data Данные
+ * @param size Количество байт
+ * @return false если соединение закрыто (SIGPIPE не посылается)
+ */
+inline bool writeFully(int fd, const void* data, std::size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+namespace detail {
+
+inline bool isTcpAddress(const std::string& address) {
+    return address.find('/') == std::string::npos && address.rfind(':') != std::string::npos;
+}
+
+inline sockaddr_un unixAddress(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Слишком длинный путь сокета: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/**
+ * @brief Разрешить адрес вида хост:порт (пустой хост — все интерфейсы)
+ */
+inline addrinfo* resolveTcp(const std::string& address, bool passive) {
+    std::size_t colon = address.rfind(':');
+    std::string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo* result = nullptr;
+    int status = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+    if (status != 0) {
+        throw std::runtime_error("Не удалось разрешить адрес " + address + ": " + gai_strerror(status));
+    }
+    return result;
+}
+
+}
+
+/**
+ * @brief Открыть слушающий сокет
+ * @param address Путь сокета Unix или хост:порт для TCP (":9000" — все интерфейсы)
+ * @return Дескриптор
+ * @throws std::runtime_error если сокет не удалось открыть
+ *
+ * Существующий файл сокета Unix удаляется.
+ */
+inline int listenOn(const std::string& address) {
+    if (!detail::isTcpAddress(address)) {
+        sockaddr_un local = detail::unixAddress(address);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(address.c_str());
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 || listen(fd, 64) != 0) {
+            int error = errno;
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("Не удалось открыть сокет " + address + ": " + std::strerror(error));
+        }
+        return fd;
+    }
+    addrinfo* list = detail::resolveTcp(address, true);
+    int fd = -1;
+    for (addrinfo* ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, 64) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+    if (fd < 0) {
+        throw std::runtime_error("Не удалось открыть сокет " + address);
+    }
+    return fd;
+}
+
+/**
+ * @brief Подключиться к сокету
+ * @param address Путь сокета Unix или хост:порт для TCP
+ * @return Дескриптор
+ * @throws std::runtime_error если подключиться не удалось
+ *
+ * Для TCP отключается алгоритм Нейгла: сообщения протоколов короткие.
+ */
+inline int connectTo(const std::string& address) {
+    if (!detail::isTcpAddress(address)) {
+        sockaddr_un remote = detail::unixAddress(address);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            int error = errno;
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("Не удалось подключиться к " + address + ": " + std::strerror(error));
+        }
+        return fd;
+    }
+    addrinfo* list = detail::resolveTcp(address, false);
+    int fd = -1;
+    for (addrinfo* ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+    if (fd < 0) {
+        throw std::runtime_error("Не удалось подключиться к " + address);
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    return fd;
+}
+
+}
+
+#endif
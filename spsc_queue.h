@@ -0,0 +1,73 @@
+#ifndef CHESS_SPSC_QUEUE_H
+#define CHESS_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Кольцевая очередь без блокировок для одного писателя и одного читателя
+ * @tparam T Тип элемента (копируемый)
+ * @tparam Capacity Ёмкость, степень двойки
+ *
+ * Писатель меняет только tail, читатель — только head; публикация
+ * элемента — запись tail с семантикой release, поэтому ни одна операция
+ * не ждёт другой поток. Индексы разнесены по разным строкам кэша.
+ */
+template <class T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Ёмкость очереди должна быть степенью двойки");
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+    /**
+     * @brief Добавить элемент (только поток-писатель)
+     * @param item Элемент
+     * @return false если очередь заполнена
+     */
+    bool push(const T& item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Извлечь элемент (только поток-читатель)
+     * @param[out] item Извлечённый элемент
+     * @return false если очередь пуста
+     */
+    bool pop(T& item) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Приблизительное число элементов (точное, если потоки не работают с очередью)
+     * @return Количество элементов
+     */
+    std::size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
+
+}
+
+#endif
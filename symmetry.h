@@ -0,0 +1,180 @@
+#ifndef CHESS_SYMMETRY_H
+#define CHESS_SYMMETRY_H
+
+#include "board.h"
+
+#include <cstdint>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Симметрии позиции
+ *
+ * Симметрия задаётся числом 0-15, биты которого выполняются по порядку:
+ * отражение слева направо (SYMMETRY_MIRROR), сверху вниз (SYMMETRY_FLIP),
+ * затем относительно диагонали a1-h8 (SYMMETRY_TRANSPOSE); младшие три
+ * бита нумеруют восемь симметрий квадрата, как в PlacementSolver.
+ * SYMMETRY_COLORS меняет цвета фигур, карманов и очереди хода.
+ *
+ * Пешек, рокировки и взятия на проходе в движке нет, поэтому законные
+ * ходы и исход партии не меняются ни при одной из восьми симметрий
+ * квадрата, ни при смене цветов: у каждой позиции до 16 равных ей
+ * позиций, и кэши, книги и таблицы эндшпиля могут хранить одну из них.
+ */
+constexpr int SYMMETRY_MIRROR = 1;     ///< (x, y) -> (7 - x, y)
+constexpr int SYMMETRY_FLIP = 2;       ///< (x, y) -> (x, 7 - y)
+constexpr int SYMMETRY_TRANSPOSE = 4;  ///< (x, y) -> (y, x), выполняется последним
+constexpr int SYMMETRY_COLORS = 8;     ///< Белые <-> чёрные
+constexpr int SYMMETRY_COUNT = 16;     ///< Количество симметрий
+
+/**
+ * @brief Обратная симметрия
+ * @param symmetry Симметрия
+ * @return Симметрия, возвращающая позицию на место
+ *
+ * Без отражения по диагонали каждая симметрия обратна сама себе;
+ * с ним отражения по осям в обратной симметрии меняются местами.
+ */
+constexpr int inverseSymmetry(int symmetry) {
+    if (!(symmetry & SYMMETRY_TRANSPOSE)) {
+        return symmetry;
+    }
+    return (symmetry & ~(SYMMETRY_MIRROR | SYMMETRY_FLIP))
+         | ((symmetry & SYMMETRY_MIRROR) ? SYMMETRY_FLIP : 0)
+         | ((symmetry & SYMMETRY_FLIP) ? SYMMETRY_MIRROR : 0);
+}
+
+/**
+ * @brief Преобразовать клетку одной из симметрий доски
+ * @param sq Номер клетки
+ * @param symmetry Номер симметрии (0 — тождественная; бит цветов не влияет)
+ * @return Номер клетки после преобразования
+ */
+constexpr int transformSquare(int sq, int symmetry) {
+    if (symmetry & SYMMETRY_MIRROR) sq ^= 7;
+    if (symmetry & SYMMETRY_FLIP) sq ^= 56;
+    if (symmetry & SYMMETRY_TRANSPOSE) sq = (squareX(sq) << 3) | squareY(sq);
+    return sq;
+}
+
+/**
+ * @brief Образ множества клеток
+ * @param b Битовая доска
+ * @param symmetry Симметрия (бит цветов не влияет)
+ * @return Битовая доска после преобразования
+ */
+constexpr Bitboard transformBitboard(Bitboard b, int symmetry) {
+    if (symmetry & SYMMETRY_MIRROR) b = mirrorHorizontal(b);
+    if (symmetry & SYMMETRY_FLIP) b = flipVertical(b);
+    if (symmetry & SYMMETRY_TRANSPOSE) b = flipDiagonal(b);
+    return b;
+}
+
+/**
+ * @brief Образ хода
+ * @param move Ход
+ * @param symmetry Симметрия
+ * @return Тот же ход в преобразованной позиции (пустой ход остаётся пустым)
+ */
+constexpr Move transformMove(Move move, int symmetry) {
+    if (move.isNone()) {
+        return move;
+    }
+    int to = transformSquare(move.to(), symmetry);
+    return move.isDrop() ? Move::drop(move.dropKind(), to)
+                         : Move::normal(transformSquare(move.from(), symmetry), to);
+}
+
+/**
+ * @brief Преобразовать позицию
+ * @param board Позиция
+ * @param symmetry Симметрия
+ * @return Новая доска с тем же вариантом правил и счётчиками ходов
+ */
+inline Board transformBoard(const Board& board, int symmetry) {
+    Board result(board.getVariant());
+    bool swap = symmetry & SYMMETRY_COLORS;
+    for (Color col : {Color::WHITE, Color::BLACK}) {
+        Color target = swap ? opposite(col) : col;
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            PieceKind kind = static_cast<PieceKind>(k);
+            for (Bitboard b = transformBitboard(board.piecesOf(col, kind), symmetry); b; ) {
+                result.putPiece(target, kind, popLowestSquare(b));
+            }
+            for (int n = board.getPocketCount(col, kind); n > 0; --n) {
+                result.addToPocket(target, kind);
+            }
+        }
+    }
+    result.setSideToMove(swap ? opposite(board.getSideToMove()) : board.getSideToMove());
+    result.setMoveCounters(board.getHalfmoveClock(), board.getFullmoveNumber());
+    return result;
+}
+
+/**
+ * @brief Каноническая форма позиции
+ */
+struct CanonicalPosition {
+    std::uint64_t key;  ///< Наименьший ключ Зобриста среди всех образов позиции
+    int symmetry;       ///< Симметрия, переводящая позицию в образ с этим ключом
+};
+
+/**
+ * @brief Найти канонический образ позиции
+ * @param board Позиция
+ * @return Канонический ключ и симметрия, дающая канонический образ
+ *
+ * Ключ равен Board::getKey() доски transformBoard(board, symmetry) и одинаков
+ * для всех симметричных позиций. Доска не строится: для каждой из восьми
+ * симметрий квадрата битовые доски преобразуются перестановками битов,
+ * а ключи обеих раскрасок набираются за один проход по фигурам.
+ */
+inline CanonicalPosition canonicalize(const Board& board) {
+    // Вклад карманов и очереди хода не зависит от расположения фигур
+    std::uint64_t sideKeys[2] = {0, 0};
+    for (int c = 0; c < COLOR_COUNT; ++c) {
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            int count = board.getPocketCount(c == 0 ? Color::WHITE : Color::BLACK, static_cast<PieceKind>(k));
+            sideKeys[0] ^= ZOBRIST.pocket[c][k][count];
+            sideKeys[1] ^= ZOBRIST.pocket[c ^ 1][k][count];
+        }
+    }
+    if (board.getSideToMove() == Color::BLACK) {
+        sideKeys[0] ^= ZOBRIST.side;
+    } else {
+        sideKeys[1] ^= ZOBRIST.side;
+    }
+
+    CanonicalPosition best{board.getKey(), 0};
+    for (int symmetry = 0; symmetry < SYMMETRY_COLORS; ++symmetry) {
+        std::uint64_t keys[2] = {sideKeys[0], sideKeys[1]};
+        for (int c = 0; c < COLOR_COUNT; ++c) {
+            for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+                Bitboard pieces = board.piecesOf(c == 0 ? Color::WHITE : Color::BLACK, static_cast<PieceKind>(k));
+                for (Bitboard b = transformBitboard(pieces, symmetry); b; ) {
+                    int sq = popLowestSquare(b);
+                    keys[0] ^= ZOBRIST.piece[c][k][sq];
+                    keys[1] ^= ZOBRIST.piece[c ^ 1][k][sq];
+                }
+            }
+        }
+        if (keys[0] < best.key) best = {keys[0], symmetry};
+        if (keys[1] < best.key) best = {keys[1], symmetry | SYMMETRY_COLORS};
+    }
+    return best;
+}
+
+/**
+ * @brief Канонический ключ позиции
+ * @param board Позиция
+ * @return Ключ, одинаковый для всех симметричных позиций
+ */
+inline std::uint64_t canonicalKey(const Board& board) { return canonicalize(board).key; }
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef CHESS_THREAD_POOL_H
+#define CHESS_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Пул рабочих потоков с общей очередью задач
+ *
+ * Потоки создаются один раз в конструкторе и завершаются в деструкторе
+ * после выполнения всех поставленных задач.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    /**
+     * @brief Конструктор пула
+     * @param threads Количество потоков (0 — по числу ядер)
+     */
+    explicit ThreadPool(unsigned threads = 0) : stopping(false) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Деструктор: дожидается выполнения очереди и останавливает потоки
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Поставить задачу в очередь
+     * @param task Вызываемый объект без аргументов
+     * @return future с результатом задачи (исключение задачи передаётся через него)
+     */
+    template <class Task>
+    auto submit(Task&& task) -> std::future<typename std::invoke_result<Task>::type> {
+        using Result = typename std::invoke_result<Task>::type;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged] { (*packaged)(); });
+        }
+        available.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Количество рабочих потоков
+     * @return Размер пула
+     */
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+};
+
+}
+
+#endif
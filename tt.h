@@ -0,0 +1,143 @@
+#ifndef CHESS_TT_H
+#define CHESS_TT_H
+
+#include "board.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+/**
+ * @brief Тип границы оценки в таблице перестановок
+ */
+enum class Bound : std::uint8_t {
+    NONE = 0,  /**< Запись пуста */
+    UPPER = 1, /**< Оценка не больше сохранённой (все ходы не дотянули до alpha) */
+    LOWER = 2, /**< Оценка не меньше сохранённой (отсечение по beta) */
+    EXACT = 3  /**< Точная оценка */
+};
+
+/**
+ * @brief Результат обращения к таблице перестановок
+ */
+struct TTEntry {
+    Move move;                ///< Лучший ход (может быть пустым)
+    int score = 0;            ///< Оценка с точки зрения стороны, делающей ход
+    int depth = 0;            ///< Глубина перебора, давшего оценку
+    Bound bound = Bound::NONE;
+};
+
+/**
+ * @brief Таблица перестановок, общая для нескольких потоков
+ *
+ * Каждая запись — два 64-битных слова: данные и ключ, сложенный с данными
+ * по XOR. Запись и чтение идут без блокировок; если два потока пишут
+ * одну запись одновременно, проверка ключа отбросит перемешанный результат.
+ * Замена: новая запись вытесняет старую, если ключи различаются или
+ * новая глубина не меньше сохранённой.
+ */
+class TranspositionTable {
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    static std::uint64_t pack(Move move, int score, int depth, Bound bound) {
+        return std::uint64_t(move.raw())
+             | (std::uint64_t(static_cast<std::uint16_t>(score)) << 16)
+             | (std::uint64_t(static_cast<std::uint8_t>(depth)) << 32)
+             | (std::uint64_t(static_cast<std::uint8_t>(bound)) << 40);
+    }
+
+public:
+    /**
+     * @brief Конструктор таблицы
+     * @param megabytes Размер в мегабайтах (округляется вниз до степени двойки записей)
+     */
+    explicit TranspositionTable(std::size_t megabytes = 16) {
+        std::size_t count = 1;
+        while (count * 2 * sizeof(Slot) <= (megabytes << 20)) {
+            count *= 2;
+        }
+        slots.reset(new Slot[count]);
+        mask = count - 1;
+    }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Очистить таблицу (не вызывать во время перебора)
+     */
+    void clear() {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Найти запись позиции
+     * @param key Ключ Зобриста
+     * @param[out] entry Найденная запись
+     * @return true если запись для этого ключа есть
+     */
+    bool probe(std::uint64_t key, TTEntry& entry) const {
+        const Slot& slot = slots[key & mask];
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        Bound bound = static_cast<Bound>((data >> 40) & 3);
+        if ((check ^ data) != key || bound == Bound::NONE) {
+            return false;
+        }
+        entry.move = Move::fromRaw(static_cast<std::uint16_t>(data));
+        entry.score = static_cast<std::int16_t>(data >> 16);
+        entry.depth = static_cast<int>((data >> 32) & 0xFF);
+        entry.bound = bound;
+        return true;
+    }
+
+    /**
+     * @brief Сохранить результат перебора позиции
+     * @param key Ключ Зобриста
+     * @param move Лучший ход
+     * @param score Оценка (матовые — относительно текущего узла)
+     * @param depth Глубина перебора
+     * @param bound Тип границы
+     */
+    void store(std::uint64_t key, Move move, int score, int depth, Bound bound) {
+        Slot& slot = slots[key & mask];
+        std::uint64_t old = slot.data.load(std::memory_order_relaxed);
+        bool sameKey = (slot.check.load(std::memory_order_relaxed) ^ old) == key;
+        if (sameKey && depth < static_cast<int>((old >> 32) & 0xFF)) {
+            return;
+        }
+        if (sameKey && move.isNone()) {
+            move = Move::fromRaw(static_cast<std::uint16_t>(old));
+        }
+        std::uint64_t data = pack(move, score, depth, bound);
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Количество записей
+     * @return Размер таблицы в записях
+     */
+    std::size_t size() const { return mask + 1; }
+};
+
+}
+
+#endif
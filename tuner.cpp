@@ -0,0 +1,132 @@
+/**
+ * @file tuner.cpp
+ * @brief Настройка параметров оценки по обучающим данным (метод Texel)
+ *
+ * Читает файлы-шарды генератора datagen, переводит позиции в разреженные
+ * векторы признаков и подбирает стоимость фигур, бонусы за положение и вес
+ * близости к королю градиентным спуском. Результат печатается как
+ * инициализатор EvalParams.
+ *
+ * Ожидаемый результат позиции — исход партии, смешанный с оценкой
+ * перебора с весом lambda (0 — только исход).
+ *
+ * Сборка: g++ -std=c++17 -O2 -pthread tuner.cpp -o tuner
+ */
+#include "datagen.h"
+#include "tuner.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Прочитать шард и добавить его позиции в набор
+ */
+size_t loadShard(const string& path, double lambda, Chess::TuningSet& set) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        throw runtime_error("Не удалось открыть " + path);
+    }
+    vector<Chess::TrainingRecord> buffer(1 << 16);
+    size_t total = 0;
+    size_t count;
+    while ((count = fread(buffer.data(), sizeof(Chess::TrainingRecord), buffer.size(), file)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            const Chess::TrainingRecord& record = buffer[i];
+            double result = (record.result + 1) / 2.0;
+            double predicted = 1.0 / (1.0 + pow(10.0, -record.score / 400.0));
+            set.add(Chess::unpackPosition(record.position), (1 - lambda) * result + lambda * predicted);
+        }
+        total += count;
+    }
+    fclose(file);
+    return total;
+}
+
+void printParams(const Chess::EvalParams& params) {
+    cout << "{\n    {";
+    for (int k = 0; k < Chess::PIECE_KIND_COUNT; ++k) {
+        cout << params.pieceValues[k] << (k + 1 < Chess::PIECE_KIND_COUNT ? ", " : "},\n");
+    }
+    cout << "    " << params.tropismWeight << ",\n    {\n";
+    for (int k = 0; k < Chess::PIECE_KIND_COUNT; ++k) {
+        cout << "        {";
+        for (int sq = 0; sq < Chess::SQUARE_COUNT; ++sq) {
+            cout << params.pieceSquare[k][sq] << (sq + 1 < Chess::SQUARE_COUNT ? (sq % 8 == 7 ? ",\n         " : ", ") : "},\n");
+        }
+    }
+    cout << "    }\n}\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Использование: " << argv[0]
+             << " <шард>... [epochs=N] [threads=N] [rate=X] [lambda=X]\n";
+        return 1;
+    }
+    vector<string> shards;
+    int epochs = 500;
+    unsigned threads = 0;
+    double rate = 1.0;
+    double lambda = 0.0;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == string::npos) {
+            shards.push_back(arg);
+            continue;
+        }
+        string key = arg.substr(0, eq), value = arg.substr(eq + 1);
+        if (key == "epochs") epochs = stoi(value);
+        else if (key == "threads") threads = stoul(value);
+        else if (key == "rate") rate = stod(value);
+        else if (key == "lambda") lambda = stod(value);
+        else {
+            cerr << "Неизвестный параметр: " << key << '\n';
+            return 1;
+        }
+    }
+
+    try {
+        auto begin = chrono::steady_clock::now();
+        Chess::TuningSet set;
+        size_t positions = 0;
+        for (const string& path : shards) {
+            positions += loadShard(path, lambda, set);
+        }
+        double loaded = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << "Загружено позиций: " << positions << " за " << loaded << " с\n";
+        if (positions == 0) {
+            return 1;
+        }
+
+        Chess::ThreadPool pool(threads);
+        Chess::TexelTuner tuner(set, pool);
+        vector<double> weights = Chess::paramsToWeights(Chess::DEFAULT_EVAL_PARAMS);
+        cout << "K = " << tuner.fitScaling(weights) << ", начальные потери " << tuner.loss(weights) << '\n';
+
+        begin = chrono::steady_clock::now();
+        tuner.tune(weights, epochs, rate, [&](int epoch, double loss) {
+            if (epoch % 50 == 0 || epoch == epochs) {
+                cout << "Эпоха " << epoch << ": потери " << loss << '\n';
+            }
+        });
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        cout << "Итоговые потери " << tuner.loss(weights) << " за " << seconds << " с\n";
+        printParams(Chess::weightsToParams(weights));
+    } catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
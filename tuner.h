@@ -0,0 +1,264 @@
+#ifndef CHESS_TUNER_H
+#define CHESS_TUNER_H
+
+#include "eval.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+constexpr int TUNE_PST_OFFSET = PIECE_KIND_COUNT; ///< Первый индекс бонусов за положение
+constexpr int TUNE_TROPISM_INDEX = TUNE_PST_OFFSET + PIECE_KIND_COUNT * SQUARE_COUNT; ///< Индекс веса близости к королю
+constexpr int TUNE_PARAM_COUNT = TUNE_TROPISM_INDEX + 1; ///< Количество настраиваемых весов
+
+/**
+ * @brief Представить параметры оценки вектором весов
+ * @param params Параметры оценки
+ * @return Веса: стоимости фигур, бонусы за положение, вес близости к королю
+ */
+inline std::vector<double> paramsToWeights(const EvalParams& params) {
+    std::vector<double> weights(TUNE_PARAM_COUNT);
+    for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+        weights[k] = params.pieceValues[k];
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            weights[TUNE_PST_OFFSET + k * SQUARE_COUNT + sq] = params.pieceSquare[k][sq];
+        }
+    }
+    weights[TUNE_TROPISM_INDEX] = params.tropismWeight;
+    return weights;
+}
+
+/**
+ * @brief Получить параметры оценки из вектора весов
+ * @param weights Веса в порядке paramsToWeights
+ * @return Параметры с весами, округлёнными до целых
+ */
+inline EvalParams weightsToParams(const std::vector<double>& weights) {
+    EvalParams params;
+    for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+        params.pieceValues[k] = static_cast<int>(std::lround(weights[k]));
+        for (int sq = 0; sq < SQUARE_COUNT; ++sq) {
+            params.pieceSquare[k][sq] =
+                static_cast<int>(std::lround(weights[TUNE_PST_OFFSET + k * SQUARE_COUNT + sq]));
+        }
+    }
+    params.tropismWeight = static_cast<int>(std::lround(weights[TUNE_TROPISM_INDEX]));
+    return params;
+}
+
+/**
+ * @brief Набор размеченных позиций в виде разреженных векторов признаков
+ *
+ * Оценка линейна по весам: evaluate() с точки зрения белых равна сумме
+ * произведений признаков на веса. Признаки всех позиций хранятся в общих
+ * массивах (индексы, коэффициенты, смещения), что даёт плотный проход по памяти.
+ */
+class TuningSet {
+private:
+    std::vector<std::uint32_t> offsets{0};
+    std::vector<std::uint16_t> indices;
+    std::vector<std::int16_t> coefficients;
+    std::vector<float> targets;
+
+    void addFeature(int index, int coefficient) {
+        if (coefficient != 0) {
+            indices.push_back(static_cast<std::uint16_t>(index));
+            coefficients.push_back(static_cast<std::int16_t>(coefficient));
+        }
+    }
+
+public:
+    /**
+     * @brief Добавить позицию
+     * @param board Позиция классического варианта
+     * @param target Ожидаемый результат для белых от 0 до 1
+     */
+    void add(const Board& board, double target) {
+        for (int k = 0; k < PIECE_KIND_COUNT; ++k) {
+            PieceKind kind = static_cast<PieceKind>(k);
+            addFeature(k, popCount(board.piecesOf(Color::WHITE, kind)) - popCount(board.piecesOf(Color::BLACK, kind)));
+            for (Color col : {Color::WHITE, Color::BLACK}) {
+                for (Bitboard b = board.piecesOf(col, kind); b; ) {
+                    addFeature(TUNE_PST_OFFSET + k * SQUARE_COUNT + relativeSquare(col, popLowestSquare(b)),
+                               col == Color::WHITE ? 1 : -1);
+                }
+            }
+        }
+        addFeature(TUNE_TROPISM_INDEX, kingTropism(board, Color::WHITE) - kingTropism(board, Color::BLACK));
+        offsets.push_back(static_cast<std::uint32_t>(indices.size()));
+        targets.push_back(static_cast<float>(target));
+    }
+
+    /**
+     * @brief Количество позиций
+     * @return Размер набора
+     */
+    std::size_t size() const { return targets.size(); }
+
+    /**
+     * @brief Линейная оценка позиции с точки зрения белых
+     * @param i Номер позиции
+     * @param weights Веса
+     * @return Сумма произведений признаков на веса
+     */
+    double evaluate(std::size_t i, const std::vector<double>& weights) const {
+        double sum = 0;
+        for (std::uint32_t f = offsets[i]; f < offsets[i + 1]; ++f) {
+            sum += coefficients[f] * weights[indices[f]];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Добавить градиент признаков позиции
+     * @param i Номер позиции
+     * @param scale Множитель (производная потерь по оценке)
+     * @param[in,out] gradient Накапливаемый градиент
+     */
+    void accumulate(std::size_t i, double scale, std::vector<double>& gradient) const {
+        for (std::uint32_t f = offsets[i]; f < offsets[i + 1]; ++f) {
+            gradient[indices[f]] += scale * coefficients[f];
+        }
+    }
+
+    /**
+     * @brief Ожидаемый результат позиции
+     * @param i Номер позиции
+     * @return Результат для белых от 0 до 1
+     */
+    double target(std::size_t i) const { return targets[i]; }
+};
+
+/**
+ * @brief Настройка оценки методом Texel
+ *
+ * Минимизирует логистическую функцию потерь (1/N) * sum (y - sigmoid(K * eval / 400))^2
+ * градиентным спуском Adam. Набор делится на равные части, которые
+ * обрабатываются параллельно в пуле потоков; частичные градиенты суммируются.
+ */
+class TexelTuner {
+private:
+    const TuningSet& data;
+    ThreadPool& pool;
+    double scaling;
+
+    double sigmoid(double eval) const { return 1.0 / (1.0 + std::pow(10.0, -scaling * eval / 400.0)); }
+
+    /**
+     * @brief Потери и (при необходимости) градиент по всему набору
+     */
+    double pass(const std::vector<double>& weights, std::vector<double>* gradient) const {
+        std::size_t parts = pool.size();
+        std::size_t chunk = (data.size() + parts - 1) / parts;
+        std::vector<std::future<double>> losses;
+        std::vector<std::vector<double>> partial(parts);
+        for (std::size_t p = 0; p < parts; ++p) {
+            losses.push_back(pool.submit([this, &weights, &partial, gradient, p, chunk]() {
+                std::size_t begin = p * chunk;
+                std::size_t end = std::min(data.size(), begin + chunk);
+                double loss = 0;
+                if (gradient) partial[p].assign(TUNE_PARAM_COUNT, 0.0);
+                const double derivative = scaling * std::log(10.0) / 400.0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    double s = sigmoid(data.evaluate(i, weights));
+                    double error = s - data.target(i);
+                    loss += error * error;
+                    if (gradient) {
+                        data.accumulate(i, 2 * error * s * (1 - s) * derivative, partial[p]);
+                    }
+                }
+                return loss;
+            }));
+        }
+        double total = 0;
+        for (std::future<double>& loss : losses) {
+            total += loss.get();
+        }
+        if (gradient) {
+            gradient->assign(TUNE_PARAM_COUNT, 0.0);
+            for (const std::vector<double>& part : partial) {
+                for (int j = 0; j < TUNE_PARAM_COUNT && !part.empty(); ++j) {
+                    (*gradient)[j] += part[j] / data.size();
+                }
+            }
+        }
+        return data.size() ? total / data.size() : 0;
+    }
+
+public:
+    /**
+     * @brief Конструктор настройщика
+     * @param set Размеченные позиции
+     * @param threadPool Пул потоков для параллельного вычисления
+     */
+    TexelTuner(const TuningSet& set, ThreadPool& threadPool) : data(set), pool(threadPool), scaling(1.0) {}
+
+    /**
+     * @brief Средние потери на наборе
+     * @param weights Веса
+     * @return Среднеквадратичная ошибка предсказания результата
+     */
+    double loss(const std::vector<double>& weights) const { return pass(weights, nullptr); }
+
+    /**
+     * @brief Подобрать масштаб K сигмоиды при фиксированных весах
+     * @param weights Исходные веса
+     * @return Найденный K (он же сохраняется для дальнейшей настройки)
+     */
+    double fitScaling(const std::vector<double>& weights) {
+        double low = 0.1, high = 4.0;
+        for (int iteration = 0; iteration < 40; ++iteration) {
+            double a = low + (high - low) / 3, b = high - (high - low) / 3;
+            scaling = a;
+            double lossA = loss(weights);
+            scaling = b;
+            double lossB = loss(weights);
+            if (lossA < lossB) high = b; else low = a;
+        }
+        scaling = (low + high) / 2;
+        return scaling;
+    }
+
+    /**
+     * @brief Выполнить эпохи градиентного спуска Adam
+     * @param[in,out] weights Настраиваемые веса
+     * @param epochs Количество эпох (полных проходов по набору)
+     * @param learningRate Шаг Adam в единицах оценки
+     * @param report Вызывается после каждой эпохи с её номером и потерями
+     */
+    template <class Report>
+    void tune(std::vector<double>& weights, int epochs, double learningRate, Report&& report) {
+        std::vector<double> gradient, m(TUNE_PARAM_COUNT, 0.0), v(TUNE_PARAM_COUNT, 0.0);
+        const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+        for (int epoch = 1; epoch <= epochs; ++epoch) {
+            double current = pass(weights, &gradient);
+            for (int j = 0; j < TUNE_PARAM_COUNT; ++j) {
+                m[j] = beta1 * m[j] + (1 - beta1) * gradient[j];
+                v[j] = beta2 * v[j] + (1 - beta2) * gradient[j] * gradient[j];
+                double mHat = m[j] / (1 - std::pow(beta1, epoch));
+                double vHat = v[j] / (1 - std::pow(beta2, epoch));
+                weights[j] -= learningRate * mHat / (std::sqrt(vHat) + epsilon);
+            }
+            report(epoch, current);
+        }
+    }
+
+    /**
+     * @brief Текущий масштаб сигмоиды
+     * @return K
+     */
+    double getScaling() const { return scaling; }
+};
+
+}
+
+#endif
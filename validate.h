@@ -0,0 +1,100 @@
+#ifndef CHESS_VALIDATE_H
+#define CHESS_VALIDATE_H
+
+#include "fen.h"
+#include "movegen.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Chess
+ * @brief Пространство имён для шахматных фигур
+ */
+namespace Chess {
+
+constexpr int GAME_VALID = -1; ///< Результат проверки партии без незаконных ходов
+
+/**
+ * @brief Проверить законность всех ходов партии
+ * @param start Начальная позиция
+ * @param moves Ходы партии
+ * @param count Количество ходов
+ * @return Номер первого незаконного полухода или GAME_VALID
+ *
+ * В отличие от ChessPiece::canMoveTo учитывает блокирующие фигуры,
+ * очередь хода, шах своему королю и окончание партии матом или патом.
+ * Каждый ход проверяется напрямую (isPseudoLegal), без генерации списка;
+ * функция не выделяет динамическую память.
+ */
+inline int validateGame(const Board& start, const Move* moves, std::size_t count) {
+    Board board = start;
+    for (std::size_t ply = 0; ply < count; ++ply) {
+        if (!isPseudoLegal(board, moves[ply])) {
+            return static_cast<int>(ply);
+        }
+        Board next = board;
+        next.makeMove(moves[ply]);
+        if (next.inCheck(board.getSideToMove())) {
+            return static_cast<int>(ply);
+        }
+        board = next;
+    }
+    return GAME_VALID;
+}
+
+/**
+ * @brief Проверить законность всех ходов партии
+ * @param startFen Начальная позиция в FEN
+ * @param moves Ходы партии
+ * @return Номер первого незаконного полухода или GAME_VALID
+ * @throws std::invalid_argument если FEN некорректен
+ */
+inline int validateGame(const std::string& startFen, const std::vector<Move>& moves) {
+    return validateGame(parseFen(startFen), moves.data(), moves.size());
+}
+
+/**
+ * @brief Партия для пакетной проверки: ссылки на данные вызывающей стороны
+ */
+struct GameView {
+    const Board* start;  ///< Начальная позиция
+    const Move* moves;   ///< Ходы
+    std::size_t count;   ///< Количество ходов
+};
+
+/**
+ * @brief Проверить много партий параллельно
+ * @param games Партии
+ * @param count Количество партий
+ * @param[out] firstIllegal Массив из count результатов validateGame
+ * @param pool Пул потоков
+ *
+ * Партии делятся на непрерывные части по несколько на поток, чтобы
+ * длинные партии не задерживали весь пакет. Выделяется память только
+ * под задачи пула, а не под каждую партию.
+ */
+inline void validateGames(const GameView* games, std::size_t count, int* firstIllegal, ThreadPool& pool) {
+    std::size_t parts = std::min<std::size_t>(count, pool.size() * 4);
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(parts);
+    for (std::size_t p = 0; p < parts; ++p) {
+        std::size_t begin = count * p / parts, end = count * (p + 1) / parts;
+        tasks.push_back(pool.submit([games, firstIllegal, begin, end]() {
+            for (std::size_t i = begin; i < end; ++i) {
+                firstIllegal[i] = validateGame(*games[i].start, games[i].moves, games[i].count);
+            }
+        }));
+    }
+    for (std::future<void>& task : tasks) {
+        task.get();
+    }
+}
+
+}
+
+#endif